@@ -0,0 +1,608 @@
+#include "ball_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// SSE2 fait partie de x86-64 : ses noyaux sont toujours utilisables quand ils sont compils
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BALL_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(GOLF_BALL_BATCH_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Le processeur et le systme (registres ymm sauvegards) permettent-ils AVX2 ?
+static bool hasAvx2()
+{
+#if !defined(GOLF_BALL_BATCH_AVX2)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+BallBatch::BallBatch()
+{
+    course = nullptr;
+    count = 0;
+    skippedSteps = 0;
+    kernel = getBestKernel();
+}
+
+void BallBatch::setKernel(BallBatchKernel newKernel)
+{
+    if (isKernelAvailable(newKernel))
+        kernel = newKernel;
+}
+
+BallBatchKernel BallBatch::getKernel() const
+{
+    return kernel;
+}
+
+BallBatchKernel BallBatch::getBestKernel()
+{
+    static const BallBatchKernel best = isKernelAvailable(BallBatchAvx2) ? BallBatchAvx2
+        : isKernelAvailable(BallBatchSse2) ? BallBatchSse2 : BallBatchScalar;
+    return best;
+}
+
+bool BallBatch::isKernelAvailable(BallBatchKernel kernel)
+{
+    if (kernel == BallBatchAvx2)
+        return hasAvx2();
+#if defined(BALL_BATCH_SSE2)
+    return true;
+#else
+    return kernel == BallBatchScalar;
+#endif
+}
+
+const char* BallBatch::getKernelName(BallBatchKernel kernel)
+{
+    if (kernel == BallBatchAvx2)
+        return "AVX2";
+    if (kernel == BallBatchSse2)
+        return "SSE2";
+    return "scalaire";
+}
+
+void BallBatch::setCourse(const CourseLibrary& courses, int index)
+{
+    course = &courses.getCourse(index);
+    walls = courses.getWalls(index);
+    clear();
+}
+
+void BallBatch::clear()
+{
+    count = 0;
+    x.clear();
+    y.clear();
+    z.clear();
+    vx.clear();
+    vy.clear();
+    vz.clear();
+    wallContacts.clear();
+    inHole.clear();
+    asleep.clear();
+    restSteps.clear();
+}
+
+int BallBatch::addBall()
+{
+    return addBall(course->startPosition);
+}
+
+int BallBatch::addBall(const glm::vec3& position)
+{
+    int index = count++;
+
+    // Agrandir les tableaux par blocs entiers pour que les noyaux n'aient jamais de reste  traiter
+    if (index >= (int)x.size())
+    {
+        size_t padded = x.size() + ballBatchWidth;
+        glm::vec3 start = course->startPosition;
+        x.resize(padded, start.x);
+        y.resize(padded, start.y);
+        z.resize(padded, start.z);
+        vx.resize(padded, 0.0f);
+        vy.resize(padded, 0.0f);
+        vz.resize(padded, 0.0f);
+        wallContacts.resize(padded, 0);
+        inHole.resize(padded, 0);
+        asleep.resize(padded, 1);
+        restSteps.resize(padded, 0);
+    }
+
+    x[index] = position.x;
+    y[index] = position.y;
+    z[index] = position.z;
+    vx[index] = 0.0f;
+    vy[index] = 0.0f;
+    vz[index] = 0.0f;
+    wallContacts[index] = 0;
+    inHole[index] = 0;
+    asleep[index] = 0;
+    restSteps[index] = 0;
+    return index;
+}
+
+void BallBatch::applyImpulse(int index, const glm::vec3& impulse)
+{
+    vx[index] += impulse.x;
+    vy[index] += impulse.y;
+    vz[index] += impulse.z;
+    asleep[index] = 0;
+    restSteps[index] = 0;
+}
+
+void BallBatch::fixedStep()
+{
+    // Une balle endormie est pose au sol avec une vitesse nulle : le noyau la laisse exactement en place,
+    // il suffit donc de sauter les blocs o toutes les balles dorment
+    activeBlocks.clear();
+    for (int first = 0; first < (int)x.size(); first += ballBatchWidth)
+    {
+        for (int i = first; i < first + ballBatchWidth; ++i)
+        {
+            if (!asleep[i])
+            {
+                activeBlocks.push_back(first);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+        skippedSteps += asleep[i];
+
+    for (int s = 0; s < subSteps; ++s)
+    {
+        integrateSubStep();
+        collideSubStep();
+    }
+
+    // Vrifier si les sphres sont entres dans le trou, et si elles s'arrtent
+    settleBlocks();
+}
+
+// Runion des murs lists dans les cases des balles veilles du bloc, dans l'ordre croissant des
+// listes des cases, avec pour chaque mur les voies dont il est dans la case : chaque balle voit
+// exactement les murs que collideWalls() lui ferait tester
+void BallBatch::gatherBlockWalls(int first)
+{
+    blockWalls.clear();
+    for (int lane = 0; lane < ballBatchWidth; ++lane)
+    {
+        int i = first + lane;
+        if (asleep[i])
+            continue;
+
+        int cellX = (int)std::floor((x[i] - walls.origin.x) / walls.cellSize);
+        int cellZ = (int)std::floor((z[i] - walls.origin.y) / walls.cellSize);
+        if (cellX < 0 || cellZ < 0 || cellX >= walls.width || cellZ >= walls.height)
+            continue;
+
+        int cell = cellZ * walls.width + cellX;
+        for (uint32_t item = walls.cellStarts[cell]; item < walls.cellStarts[cell + 1]; ++item)
+            blockWalls.push_back((walls.cellItems[item] << ballBatchWidth) | (1u << lane));
+    }
+
+    // Un seul passage par mur, voies runies
+    std::sort(blockWalls.begin(), blockWalls.end());
+    size_t merged = 0;
+    for (size_t i = 0; i < blockWalls.size(); ++i)
+    {
+        if (merged > 0 && (blockWalls[merged - 1] >> ballBatchWidth) == (blockWalls[i] >> ballBatchWidth))
+            blockWalls[merged - 1] |= blockWalls[i];
+        else
+            blockWalls[merged++] = blockWalls[i];
+    }
+    blockWalls.resize(merged);
+}
+
+// Comptabilit d'une balle veille en fin de pas ; les vitesses ont dj t annules dans le trou
+void BallBatch::settleBall(int index, bool reachedHole, bool atRest)
+{
+    if (reachedHole)
+        inHole[index] = 1;
+
+    if (atRest)
+    {
+        restSteps[index]++;
+        if (restSteps[index] >= sleepSteps)
+        {
+            vx[index] = 0.0f;
+            vy[index] = 0.0f;
+            vz[index] = 0.0f;
+            asleep[index] = 1;
+        }
+    }
+    else
+    {
+        restSteps[index] = 0;
+    }
+}
+
+void BallBatch::integrateSubStep()
+{
+#if defined(GOLF_BALL_BATCH_AVX2)
+    if (kernel == BallBatchAvx2)
+    {
+        integrateSubStepAvx2();
+        return;
+    }
+#endif
+#if defined(BALL_BATCH_SSE2)
+    if (kernel == BallBatchSse2)
+    {
+        integrateSubStepSse2();
+        return;
+    }
+#endif
+    integrateSubStepScalar();
+}
+
+void BallBatch::collideSubStep()
+{
+#if defined(GOLF_BALL_BATCH_AVX2)
+    if (kernel == BallBatchAvx2)
+    {
+        collideSubStepAvx2();
+        return;
+    }
+#endif
+#if defined(BALL_BATCH_SSE2)
+    if (kernel == BallBatchSse2)
+    {
+        collideSubStepSse2();
+        return;
+    }
+#endif
+    collideSubStepScalar();
+}
+
+void BallBatch::settleBlocks()
+{
+#if defined(GOLF_BALL_BATCH_AVX2)
+    if (kernel == BallBatchAvx2)
+    {
+        settleBlocksAvx2();
+        return;
+    }
+#endif
+#if defined(BALL_BATCH_SSE2)
+    if (kernel == BallBatchSse2)
+    {
+        settleBlocksSse2();
+        return;
+    }
+#endif
+    settleBlocksScalar();
+}
+
+void BallBatch::integrateSubStepScalar()
+{
+    for (int first : activeBlocks)
+    {
+        for (int i = first; i < first + ballBatchWidth; ++i)
+        {
+            y[i] += vy[i] / subSteps;
+            x[i] += vx[i] / subSteps;
+            z[i] += vz[i] / subSteps;
+
+            vx[i] *= subStepFriction;
+            vy[i] *= subStepFriction;
+            vz[i] *= subStepFriction;
+
+            vy[i] -= gravity / subSteps;
+
+            if (y[i] <= ballRadius)
+            {
+                y[i] = ballRadius;
+                vy[i] *= -dampingFactor;
+                if (std::abs(vy[i]) < minBounceSpeed)
+                {
+                    vy[i] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+void BallBatch::collideSubStepScalar()
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (asleep[i])
+            continue;
+
+        glm::vec3 position(x[i], y[i], z[i]);
+        glm::vec3 velocity(vx[i], vy[i], vz[i]);
+        checkSphereBounds(walls, position, velocity, wallContacts[i]);
+        x[i] = position.x;
+        y[i] = position.y;
+        z[i] = position.z;
+        vx[i] = velocity.x;
+        vy[i] = velocity.y;
+        vz[i] = velocity.z;
+    }
+}
+
+void BallBatch::settleBlocksScalar()
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (asleep[i])
+            continue;
+
+        bool reachedHole = checkHoleCollision(glm::vec3(x[i], y[i], z[i]), course->holePosition);
+        if (reachedHole)
+        {
+            vx[i] = 0.0f;
+            vy[i] = 0.0f;
+            vz[i] = 0.0f;
+        }
+        settleBall(i, reachedHole, isAtRest(i));
+    }
+}
+
+#if defined(BALL_BATCH_SSE2)
+
+// Un bloc en deux moitis de 4 balles
+const int sse2Width = 4;
+
+void BallBatch::integrateSubStepSse2()
+{
+    const __m128 steps = _mm_set1_ps((float)subSteps);
+    const __m128 frictionFactor = _mm_set1_ps(subStepFriction);
+    const __m128 gravityStep = _mm_set1_ps(gravity / subSteps);
+    const __m128 ground = _mm_set1_ps(ballRadius);
+    const __m128 damping = _mm_set1_ps(-dampingFactor);
+    const __m128 minSpeed = _mm_set1_ps(minBounceSpeed);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    for (int first : activeBlocks)
+    {
+        for (int i = first; i < first + ballBatchWidth; i += sse2Width)
+        {
+            __m128 px = _mm_loadu_ps(&x[i]);
+            __m128 py = _mm_loadu_ps(&y[i]);
+            __m128 pz = _mm_loadu_ps(&z[i]);
+            __m128 velX = _mm_loadu_ps(&vx[i]);
+            __m128 velY = _mm_loadu_ps(&vy[i]);
+            __m128 velZ = _mm_loadu_ps(&vz[i]);
+
+            py = _mm_add_ps(py, _mm_div_ps(velY, steps));
+            px = _mm_add_ps(px, _mm_div_ps(velX, steps));
+            pz = _mm_add_ps(pz, _mm_div_ps(velZ, steps));
+
+            velX = _mm_mul_ps(velX, frictionFactor);
+            velY = _mm_mul_ps(velY, frictionFactor);
+            velZ = _mm_mul_ps(velZ, frictionFactor);
+
+            velY = _mm_sub_ps(velY, gravityStep);
+
+            // SSE2 n'a pas de blendv : slection par and/andnot/or
+            __m128 onGround = _mm_cmple_ps(py, ground);
+            __m128 bounced = _mm_mul_ps(velY, damping);
+            __m128 tooSlow = _mm_cmplt_ps(_mm_and_ps(bounced, absMask), minSpeed);
+            bounced = _mm_andnot_ps(tooSlow, bounced);
+            py = _mm_or_ps(_mm_and_ps(onGround, ground), _mm_andnot_ps(onGround, py));
+            velY = _mm_or_ps(_mm_and_ps(onGround, bounced), _mm_andnot_ps(onGround, velY));
+
+            _mm_storeu_ps(&x[i], px);
+            _mm_storeu_ps(&y[i], py);
+            _mm_storeu_ps(&z[i], pz);
+            _mm_storeu_ps(&vx[i], velX);
+            _mm_storeu_ps(&vy[i], velY);
+            _mm_storeu_ps(&vz[i], velZ);
+        }
+    }
+}
+
+// SSE2 n'a pas de blendv : slection par and/andnot/or
+static inline __m128 blendLanes(__m128 a, __m128 b, __m128 mask)
+{
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// Masque des voies veilles  partir de quatre octets de asleep
+static inline __m128 getAwakeLanes(const unsigned char* sleeping)
+{
+    int bytes;
+    std::memcpy(&bytes, sleeping, sizeof(bytes));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lanes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(lanes, zero));
+}
+
+void BallBatch::collideSubStepSse2()
+{
+    const __m128 radius = _mm_set1_ps(ballRadius);
+    const __m128 radiusSquared = _mm_set1_ps(ballRadius * ballRadius);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 damping = _mm_set1_ps(dampingFactor);
+    const __m128 groundDamping = _mm_set1_ps(-dampingFactor);
+    const __m128 minSpeed = _mm_set1_ps(minBounceSpeed);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128i laneMasks = _mm_setr_epi32(1, 2, 4, 8);
+
+    for (int first : activeBlocks)
+    {
+        gatherBlockWalls(first);
+        for (int i = first; i < first + ballBatchWidth; i += sse2Width)
+        {
+            // Voies veilles : une balle endormie ne bouge pas, mme pose contre un mur
+            __m128 awake = getAwakeLanes(&asleep[i]);
+
+            __m128 px = _mm_loadu_ps(&x[i]);
+            __m128 pz = _mm_loadu_ps(&z[i]);
+            __m128 velX = _mm_loadu_ps(&vx[i]);
+            __m128 velZ = _mm_loadu_ps(&vz[i]);
+            __m128i contacts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&wallContacts[i]));
+
+            // Un mur diffus aux voies de sa case, mmes calculs que collideWall()
+            for (uint32_t entry : blockWalls)
+            {
+                const WallSegment& segment = walls.segments[entry >> ballBatchWidth];
+                __m128i laneBits = _mm_and_si128(_mm_set1_epi32(entry >> (i - first)), laneMasks);
+                __m128 inCell = _mm_castsi128_ps(_mm_cmpeq_epi32(laneBits, laneMasks));
+                glm::vec2 direction = segment.end - segment.start;
+                glm::vec2 faceNormal = glm::normalize(glm::vec2(-direction.y, direction.x));
+                const __m128 startX = _mm_set1_ps(segment.start.x);
+                const __m128 startZ = _mm_set1_ps(segment.start.y);
+                const __m128 directionX = _mm_set1_ps(direction.x);
+                const __m128 directionZ = _mm_set1_ps(direction.y);
+
+                __m128 t = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(px, startX), directionX), _mm_mul_ps(_mm_sub_ps(pz, startZ), directionZ));
+                t = _mm_div_ps(t, _mm_set1_ps(glm::dot(direction, direction)));
+                t = _mm_min_ps(_mm_max_ps(t, zero), one);
+                __m128 closestX = _mm_add_ps(startX, _mm_mul_ps(directionX, t));
+                __m128 closestZ = _mm_add_ps(startZ, _mm_mul_ps(directionZ, t));
+
+                __m128 offsetX = _mm_sub_ps(px, closestX);
+                __m128 offsetZ = _mm_sub_ps(pz, closestZ);
+                __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetZ, offsetZ));
+                __m128 touching = _mm_and_ps(_mm_cmplt_ps(distanceSquared, radiusSquared), inCell);
+                if (_mm_movemask_ps(touching) == 0)
+                    continue; // Aucune balle du bloc  porte : le cas courant
+
+                __m128 distance = _mm_sqrt_ps(distanceSquared);
+                __m128 apart = _mm_cmpgt_ps(distance, zero);
+                __m128 normalX = blendLanes(_mm_set1_ps(faceNormal.x), _mm_div_ps(offsetX, distance), apart);
+                __m128 normalZ = blendLanes(_mm_set1_ps(faceNormal.y), _mm_div_ps(offsetZ, distance), apart);
+
+                // Repositionner contre le mur, ne rflchir que les balles qui vont vers lui
+                px = blendLanes(px, _mm_add_ps(closestX, _mm_mul_ps(normalX, radius)), touching);
+                pz = blendLanes(pz, _mm_add_ps(closestZ, _mm_mul_ps(normalZ, radius)), touching);
+
+                __m128 normalSpeed = _mm_add_ps(_mm_mul_ps(velX, normalX), _mm_mul_ps(velZ, normalZ));
+                __m128 bouncing = _mm_and_ps(touching, _mm_cmplt_ps(normalSpeed, zero));
+                __m128 bounceSpeed = _mm_mul_ps(_mm_sub_ps(zero, normalSpeed), damping);
+                bounceSpeed = _mm_andnot_ps(_mm_cmplt_ps(bounceSpeed, minSpeed), bounceSpeed);
+                __m128 change = _mm_sub_ps(bounceSpeed, normalSpeed);
+                velX = blendLanes(velX, _mm_add_ps(velX, _mm_mul_ps(normalX, change)), bouncing);
+                velZ = blendLanes(velZ, _mm_add_ps(velZ, _mm_mul_ps(normalZ, change)), bouncing);
+                contacts = _mm_sub_epi32(contacts, _mm_castps_si128(bouncing)); // Masque  -1 : +1 impact
+            }
+
+            // Sol, aprs les murs comme dans checkSphereBounds()
+            __m128 py = _mm_loadu_ps(&y[i]);
+            __m128 velY = _mm_loadu_ps(&vy[i]);
+            __m128 onGround = _mm_and_ps(_mm_cmple_ps(py, radius), awake);
+            __m128 bounced = _mm_mul_ps(velY, groundDamping);
+            bounced = _mm_andnot_ps(_mm_cmplt_ps(_mm_and_ps(bounced, absMask), minSpeed), bounced);
+            py = blendLanes(py, radius, onGround);
+            velY = blendLanes(velY, bounced, onGround);
+
+            _mm_storeu_ps(&x[i], px);
+            _mm_storeu_ps(&y[i], py);
+            _mm_storeu_ps(&z[i], pz);
+            _mm_storeu_ps(&vx[i], velX);
+            _mm_storeu_ps(&vy[i], velY);
+            _mm_storeu_ps(&vz[i], velZ);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&wallContacts[i]), contacts);
+        }
+    }
+}
+
+void BallBatch::settleBlocksSse2()
+{
+    const __m128 holeX = _mm_set1_ps(course->holePosition.x);
+    const __m128 holeY = _mm_set1_ps(course->holePosition.y);
+    const __m128 holeZ = _mm_set1_ps(course->holePosition.z);
+    const __m128 holeDistance = _mm_set1_ps(holeRadius);
+    const __m128 ground = _mm_set1_ps(ballRadius);
+    const __m128 stopSpeed = _mm_set1_ps(restSpeed);
+
+    for (int first : activeBlocks)
+    {
+        for (int i = first; i < first + ballBatchWidth; i += sse2Width)
+        {
+            __m128 awake = getAwakeLanes(&asleep[i]);
+
+            __m128 py = _mm_loadu_ps(&y[i]);
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(&x[i]), holeX);
+            __m128 dy = _mm_sub_ps(py, holeY);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(&z[i]), holeZ);
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+            __m128 reached = _mm_and_ps(_mm_cmplt_ps(distance, holeDistance), awake);
+
+            // Balle dans le trou : arrte avant le test d'arrt, comme dans Physics
+            __m128 velX = _mm_andnot_ps(reached, _mm_loadu_ps(&vx[i]));
+            __m128 velY = _mm_andnot_ps(reached, _mm_loadu_ps(&vy[i]));
+            __m128 velZ = _mm_andnot_ps(reached, _mm_loadu_ps(&vz[i]));
+            _mm_storeu_ps(&vx[i], velX);
+            _mm_storeu_ps(&vy[i], velY);
+            _mm_storeu_ps(&vz[i], velZ);
+
+            __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(velX, velX), _mm_mul_ps(velY, velY)), _mm_mul_ps(velZ, velZ)));
+            __m128 atRest = _mm_and_ps(_mm_cmple_ps(py, ground), _mm_cmplt_ps(speed, stopSpeed));
+
+            int reachedLanes = _mm_movemask_ps(reached);
+            int restLanes = _mm_movemask_ps(atRest);
+            for (int lane = 0; lane < sse2Width; ++lane)
+            {
+                if (!asleep[i + lane])
+                    settleBall(i + lane, (reachedLanes >> lane) & 1, (restLanes >> lane) & 1);
+            }
+        }
+    }
+}
+
+#endif
+
+int BallBatch::size() const
+{
+    return count;
+}
+
+glm::vec3 BallBatch::getPosition(int index) const
+{
+    return glm::vec3(x[index], y[index], z[index]);
+}
+
+glm::vec3 BallBatch::getVelocity(int index) const
+{
+    return glm::vec3(vx[index], vy[index], vz[index]);
+}
+
+bool BallBatch::isInHole(int index) const
+{
+    return inHole[index] != 0;
+}
+
+bool BallBatch::isAtRest(int index) const
+{
+    return y[index] <= ballRadius && glm::length(getVelocity(index)) < restSpeed;
+}
+
+bool BallBatch::isAsleep(int index) const
+{
+    return asleep[index] != 0;
+}
+
+int BallBatch::getWallContacts(int index) const
+{
+    return wallContacts[index];
+}
+
+long long BallBatch::getSkippedSteps() const
+{
+    return skippedSteps;
+}
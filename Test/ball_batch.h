@@ -0,0 +1,88 @@
+#pragma once
+#include "physics.h"
+#include <vector>
+
+// Balles par bloc : la largeur des noyaux AVX2. Les noyaux SSE2 traitent un bloc en deux moitis,
+// le noyau scalaire balle par balle
+const int ballBatchWidth = 8;
+
+// Noyaux de BallBatch, du plus troit au plus large
+enum BallBatchKernel
+{
+    BallBatchScalar,
+    BallBatchSse2,
+    BallBatchAvx2  // Seulement si compil (GOLF_BALL_BATCH_AVX2) et si le processeur le permet
+};
+
+// Simulation de plusieurs balles  la fois, stockes en structure de tableaux (x, y, z, vx, vy, vz).
+// L'intgration, la friction, la gravit, le rebond au sol, les murs et le trou passent par les
+// noyaux SIMD avec les mmes rgles que Physics (collisions discrtes) : pour les murs, chaque bloc
+// runit les murs des cases de ses balles, et chaque mur est diffus aux voies dont il est dans la case.
+// Les balles  l'arrt s'endorment comme dans Physics : un bloc SIMD entirement endormi est saut.
+// Le noyau est choisi  l'excution selon le processeur ; tous donnent exactement les rsultats de Physics.
+class BallBatch
+{
+
+public:
+
+    BallBatch();
+
+    void setCourse(const CourseLibrary& courses, int index);
+    void clear();
+    int addBall(); // Ajoute une balle au dpart du parcours, retourne son indice
+    int addBall(const glm::vec3& position);
+    void applyImpulse(int index, const glm::vec3& impulse);
+
+    void fixedStep(); // Un pas fixe pour toutes les balles
+
+    int size() const;
+    glm::vec3 getPosition(int index) const;
+    glm::vec3 getVelocity(int index) const;
+    bool isInHole(int index) const;
+    bool isAtRest(int index) const;
+    bool isAsleep(int index) const;
+    int getWallContacts(int index) const;
+    long long getSkippedSteps() const; // Pas de balle vits pendant le sommeil
+
+    void setKernel(BallBatchKernel kernel); // Pour comparer les noyaux ; ignor s'il n'est pas disponible
+    BallBatchKernel getKernel() const;
+
+    static BallBatchKernel getBestKernel(); // Le plus large disponible, choisi au constructeur
+    static bool isKernelAvailable(BallBatchKernel kernel);
+    static const char* getKernelName(BallBatchKernel kernel);
+
+private:
+
+    const Course* course;
+    WallSet walls;
+    int count;
+
+    // Tableaux complts jusqu' un multiple de ballBatchWidth
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<int> wallContacts;
+    std::vector<unsigned char> inHole;
+    std::vector<unsigned char> asleep; // Les balles de remplissage sont toujours endormies
+    std::vector<int> restSteps;
+    std::vector<int> activeBlocks; // Premiers indices des blocs ayant au moins une balle veille
+    std::vector<uint32_t> blockWalls; // Murs des cases d'un bloc, croissants : (mur << ballBatchWidth) | voies concernes
+    long long skippedSteps;
+    BallBatchKernel kernel;
+
+    // Noyaux, sur les blocs actifs : position, friction, gravit et sol ; murs puis sol (checkSphereBounds) ;
+    // trou et arrt, en fin de pas. Les versions AVX2 sont dans ball_batch_avx2.cpp
+    void integrateSubStep();
+    void collideSubStep();
+    void settleBlocks();
+    void integrateSubStepScalar();
+    void collideSubStepScalar();
+    void settleBlocksScalar();
+    void integrateSubStepSse2();
+    void collideSubStepSse2();
+    void settleBlocksSse2();
+    void integrateSubStepAvx2();
+    void collideSubStepAvx2();
+    void settleBlocksAvx2();
+    void gatherBlockWalls(int first);
+    void settleBall(int index, bool reachedHole, bool atRest);
+};
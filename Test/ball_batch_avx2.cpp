@@ -0,0 +1,184 @@
+// Noyaux AVX2 de BallBatch, 8 balles par instruction. Seul ce fichier est compil pour AVX2
+// (option GOLF_ENABLE_AVX2) : BallBatch ne l'appelle que si le processeur le permet, le reste
+// du programme (Physics compris) garde le jeu d'instructions de base et ses arrondis.
+
+#include "ball_batch.h"
+#include <immintrin.h>
+
+void BallBatch::integrateSubStepAvx2()
+{
+    const __m256 steps = _mm256_set1_ps((float)subSteps);
+    const __m256 frictionFactor = _mm256_set1_ps(subStepFriction);
+    const __m256 gravityStep = _mm256_set1_ps(gravity / subSteps);
+    const __m256 ground = _mm256_set1_ps(ballRadius);
+    const __m256 damping = _mm256_set1_ps(-dampingFactor);
+    const __m256 minSpeed = _mm256_set1_ps(minBounceSpeed);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    for (int i : activeBlocks)
+    {
+        __m256 px = _mm256_loadu_ps(&x[i]);
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 pz = _mm256_loadu_ps(&z[i]);
+        __m256 velX = _mm256_loadu_ps(&vx[i]);
+        __m256 velY = _mm256_loadu_ps(&vy[i]);
+        __m256 velZ = _mm256_loadu_ps(&vz[i]);
+
+        py = _mm256_add_ps(py, _mm256_div_ps(velY, steps));
+        px = _mm256_add_ps(px, _mm256_div_ps(velX, steps));
+        pz = _mm256_add_ps(pz, _mm256_div_ps(velZ, steps));
+
+        velX = _mm256_mul_ps(velX, frictionFactor);
+        velY = _mm256_mul_ps(velY, frictionFactor);
+        velZ = _mm256_mul_ps(velZ, frictionFactor);
+
+        velY = _mm256_sub_ps(velY, gravityStep);
+
+        // Rebond au sol sans branchement : on calcule la vitesse rebondie et on la slectionne par masque
+        __m256 onGround = _mm256_cmp_ps(py, ground, _CMP_LE_OQ);
+        __m256 bounced = _mm256_mul_ps(velY, damping);
+        __m256 tooSlow = _mm256_cmp_ps(_mm256_and_ps(bounced, absMask), minSpeed, _CMP_LT_OQ);
+        bounced = _mm256_andnot_ps(tooSlow, bounced);
+        py = _mm256_blendv_ps(py, ground, onGround);
+        velY = _mm256_blendv_ps(velY, bounced, onGround);
+
+        _mm256_storeu_ps(&x[i], px);
+        _mm256_storeu_ps(&y[i], py);
+        _mm256_storeu_ps(&z[i], pz);
+        _mm256_storeu_ps(&vx[i], velX);
+        _mm256_storeu_ps(&vy[i], velY);
+        _mm256_storeu_ps(&vz[i], velZ);
+    }
+}
+
+void BallBatch::collideSubStepAvx2()
+{
+    const __m256 radius = _mm256_set1_ps(ballRadius);
+    const __m256 radiusSquared = _mm256_set1_ps(ballRadius * ballRadius);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 damping = _mm256_set1_ps(dampingFactor);
+    const __m256 groundDamping = _mm256_set1_ps(-dampingFactor);
+    const __m256 minSpeed = _mm256_set1_ps(minBounceSpeed);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256i laneMasks = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+    for (int i : activeBlocks)
+    {
+        gatherBlockWalls(i);
+
+        // Voies veilles : une balle endormie ne bouge pas, mme pose contre un mur
+        __m128i sleeping = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&asleep[i]));
+        __m256 awake = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(sleeping), _mm256_setzero_si256()));
+
+        __m256 px = _mm256_loadu_ps(&x[i]);
+        __m256 pz = _mm256_loadu_ps(&z[i]);
+        __m256 velX = _mm256_loadu_ps(&vx[i]);
+        __m256 velZ = _mm256_loadu_ps(&vz[i]);
+        __m256i contacts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&wallContacts[i]));
+
+        // Un mur diffus aux voies de sa case, mmes calculs que collideWall()
+        for (uint32_t entry : blockWalls)
+        {
+            const WallSegment& segment = walls.segments[entry >> ballBatchWidth];
+            __m256i laneBits = _mm256_and_si256(_mm256_set1_epi32(entry), laneMasks);
+            __m256 inCell = _mm256_castsi256_ps(_mm256_cmpeq_epi32(laneBits, laneMasks));
+            glm::vec2 direction = segment.end - segment.start;
+            glm::vec2 faceNormal = glm::normalize(glm::vec2(-direction.y, direction.x));
+            const __m256 startX = _mm256_set1_ps(segment.start.x);
+            const __m256 startZ = _mm256_set1_ps(segment.start.y);
+            const __m256 directionX = _mm256_set1_ps(direction.x);
+            const __m256 directionZ = _mm256_set1_ps(direction.y);
+
+            __m256 t = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(px, startX), directionX), _mm256_mul_ps(_mm256_sub_ps(pz, startZ), directionZ));
+            t = _mm256_div_ps(t, _mm256_set1_ps(glm::dot(direction, direction)));
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            __m256 closestX = _mm256_add_ps(startX, _mm256_mul_ps(directionX, t));
+            __m256 closestZ = _mm256_add_ps(startZ, _mm256_mul_ps(directionZ, t));
+
+            __m256 offsetX = _mm256_sub_ps(px, closestX);
+            __m256 offsetZ = _mm256_sub_ps(pz, closestZ);
+            __m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(offsetX, offsetX), _mm256_mul_ps(offsetZ, offsetZ));
+            __m256 touching = _mm256_and_ps(_mm256_cmp_ps(distanceSquared, radiusSquared, _CMP_LT_OQ), inCell);
+            if (_mm256_movemask_ps(touching) == 0)
+                continue; // Aucune balle du bloc  porte : le cas courant
+
+            __m256 distance = _mm256_sqrt_ps(distanceSquared);
+            __m256 apart = _mm256_cmp_ps(distance, zero, _CMP_GT_OQ);
+            __m256 normalX = _mm256_blendv_ps(_mm256_set1_ps(faceNormal.x), _mm256_div_ps(offsetX, distance), apart);
+            __m256 normalZ = _mm256_blendv_ps(_mm256_set1_ps(faceNormal.y), _mm256_div_ps(offsetZ, distance), apart);
+
+            // Repositionner contre le mur, ne rflchir que les balles qui vont vers lui
+            px = _mm256_blendv_ps(px, _mm256_add_ps(closestX, _mm256_mul_ps(normalX, radius)), touching);
+            pz = _mm256_blendv_ps(pz, _mm256_add_ps(closestZ, _mm256_mul_ps(normalZ, radius)), touching);
+
+            __m256 normalSpeed = _mm256_add_ps(_mm256_mul_ps(velX, normalX), _mm256_mul_ps(velZ, normalZ));
+            __m256 bouncing = _mm256_and_ps(touching, _mm256_cmp_ps(normalSpeed, zero, _CMP_LT_OQ));
+            __m256 bounceSpeed = _mm256_mul_ps(_mm256_sub_ps(zero, normalSpeed), damping);
+            bounceSpeed = _mm256_andnot_ps(_mm256_cmp_ps(bounceSpeed, minSpeed, _CMP_LT_OQ), bounceSpeed);
+            __m256 change = _mm256_sub_ps(bounceSpeed, normalSpeed);
+            velX = _mm256_blendv_ps(velX, _mm256_add_ps(velX, _mm256_mul_ps(normalX, change)), bouncing);
+            velZ = _mm256_blendv_ps(velZ, _mm256_add_ps(velZ, _mm256_mul_ps(normalZ, change)), bouncing);
+            contacts = _mm256_sub_epi32(contacts, _mm256_castps_si256(bouncing)); // Masque  -1 : +1 impact
+        }
+
+        // Sol, aprs les murs comme dans checkSphereBounds()
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 velY = _mm256_loadu_ps(&vy[i]);
+        __m256 onGround = _mm256_and_ps(_mm256_cmp_ps(py, radius, _CMP_LE_OQ), awake);
+        __m256 bounced = _mm256_mul_ps(velY, groundDamping);
+        bounced = _mm256_andnot_ps(_mm256_cmp_ps(_mm256_and_ps(bounced, absMask), minSpeed, _CMP_LT_OQ), bounced);
+        py = _mm256_blendv_ps(py, radius, onGround);
+        velY = _mm256_blendv_ps(velY, bounced, onGround);
+
+        _mm256_storeu_ps(&x[i], px);
+        _mm256_storeu_ps(&y[i], py);
+        _mm256_storeu_ps(&z[i], pz);
+        _mm256_storeu_ps(&vx[i], velX);
+        _mm256_storeu_ps(&vy[i], velY);
+        _mm256_storeu_ps(&vz[i], velZ);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&wallContacts[i]), contacts);
+    }
+}
+
+void BallBatch::settleBlocksAvx2()
+{
+    const __m256 holeX = _mm256_set1_ps(course->holePosition.x);
+    const __m256 holeY = _mm256_set1_ps(course->holePosition.y);
+    const __m256 holeZ = _mm256_set1_ps(course->holePosition.z);
+    const __m256 holeDistance = _mm256_set1_ps(holeRadius);
+    const __m256 ground = _mm256_set1_ps(ballRadius);
+    const __m256 stopSpeed = _mm256_set1_ps(restSpeed);
+
+    for (int i : activeBlocks)
+    {
+        __m128i sleeping = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&asleep[i]));
+        __m256 awake = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(sleeping), _mm256_setzero_si256()));
+
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&x[i]), holeX);
+        __m256 dy = _mm256_sub_ps(py, holeY);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&z[i]), holeZ);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+        __m256 reached = _mm256_and_ps(_mm256_cmp_ps(distance, holeDistance, _CMP_LT_OQ), awake);
+
+        // Balle dans le trou : arrte avant le test d'arrt, comme dans Physics
+        __m256 velX = _mm256_andnot_ps(reached, _mm256_loadu_ps(&vx[i]));
+        __m256 velY = _mm256_andnot_ps(reached, _mm256_loadu_ps(&vy[i]));
+        __m256 velZ = _mm256_andnot_ps(reached, _mm256_loadu_ps(&vz[i]));
+        _mm256_storeu_ps(&vx[i], velX);
+        _mm256_storeu_ps(&vy[i], velY);
+        _mm256_storeu_ps(&vz[i], velZ);
+
+        __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(velX, velX), _mm256_mul_ps(velY, velY)), _mm256_mul_ps(velZ, velZ)));
+        __m256 atRest = _mm256_and_ps(_mm256_cmp_ps(py, ground, _CMP_LE_OQ), _mm256_cmp_ps(speed, stopSpeed, _CMP_LT_OQ));
+
+        int reachedLanes = _mm256_movemask_ps(reached);
+        int restLanes = _mm256_movemask_ps(atRest);
+        for (int lane = 0; lane < ballBatchWidth; ++lane)
+        {
+            if (!asleep[i + lane])
+                settleBall(i + lane, (reachedLanes >> lane) & 1, (restLanes >> lane) & 1);
+        }
+    }
+}
@@ -1,7 +1,6 @@
 #version 330 core
 out vec4 FragColor;
 
-in vec3 ourColor;
 in vec2 TexCoords;
 
 uniform vec4 color;
@@ -15,5 +14,5 @@ void main()
     // Color the fragment based on the pattern
     vec3 patternColor = mix(vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 1.0), pattern); // Red and Blue
 
-    FragColor = vec4(patternColor * ourColor, 1.0);
+    FragColor = vec4(patternColor, 1.0);
 }
@@ -1,17 +1,21 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aColor;
 
-out vec3 ourColor;
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
 
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
-    ourColor = aColor;
     TexCoords = aPos.xy; // Use the position for texturing
 }
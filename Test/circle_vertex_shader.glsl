@@ -2,10 +2,17 @@
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
 
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+}
@@ -0,0 +1,219 @@
+#include "collision.h"
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool collideWall(const WallSegment& wall, glm::vec3& position, glm::vec3& velocity)
+{
+    // Point du mur le plus proche du centre de la balle
+    glm::vec2 center(position.x, position.z);
+    glm::vec2 wallDirection = wall.end - wall.start;
+    float t = glm::clamp(glm::dot(center - wall.start, wallDirection) / glm::dot(wallDirection, wallDirection), 0.0f, 1.0f);
+    glm::vec2 closest = wall.start + wallDirection * t;
+
+    glm::vec2 offset = center - closest;
+    float distanceSquared = glm::dot(offset, offset);
+    if (distanceSquared >= ballRadius * ballRadius)
+        return false;
+
+    float distance = std::sqrt(distanceSquared);
+    glm::vec2 normal = distance > 0.0f ? offset / distance : glm::normalize(glm::vec2(-wallDirection.y, wallDirection.x));
+
+    // Repositionner la sphre contre le mur
+    center = closest + normal * ballRadius;
+    position.x = center.x;
+    position.z = center.y;
+
+    // Ne rflchir que si la balle va vers le mur
+    glm::vec2 planarVelocity(velocity.x, velocity.z);
+    float normalSpeed = glm::dot(planarVelocity, normal);
+    if (normalSpeed >= 0.0f)
+        return false;
+
+    float bounceSpeed = -normalSpeed * dampingFactor;
+    if (bounceSpeed < minBounceSpeed)
+        bounceSpeed = 0.0f;
+
+    planarVelocity += normal * (bounceSpeed - normalSpeed);
+    velocity.x = planarVelocity.x;
+    velocity.z = planarVelocity.y;
+    return true;
+}
+
+int collideWalls(const WallSet& walls, glm::vec3& position, glm::vec3& velocity)
+{
+    int cellX = (int)std::floor((position.x - walls.origin.x) / walls.cellSize);
+    int cellZ = (int)std::floor((position.z - walls.origin.y) / walls.cellSize);
+
+    // Hors de la grille : aucun mur  porte
+    if (cellX < 0 || cellZ < 0 || cellX >= walls.width || cellZ >= walls.height)
+        return 0;
+
+    int cell = cellZ * walls.width + cellX;
+    int contacts = 0;
+    for (uint32_t i = walls.cellStarts[cell]; i < walls.cellStarts[cell + 1]; ++i)
+    {
+        if (collideWall(walls.segments[walls.cellItems[i]], position, velocity))
+            contacts++;
+    }
+    return contacts;
+}
+
+// Une balle dont la vitesse vers le mur ne dpasse pas grazingSpeed fois sa vitesse le frle :
+// c'est le reste des arrondis d'une rflexion qui a annul la vitesse normale
+static const float grazingSpeed = 1e-5f;
+
+// Un contact  moins de contactSlop du point de dpart, de normale presque identique  celle du
+// dernier impact, est ce mme impact
+static const float contactSlop = 1e-4f;
+static const float sameContactCosine = 0.9999f;
+
+// Balle contre un coin de mur (cercle de rayon ballRadius autour de l'extrmit)
+static bool sweepCorner(const glm::vec2& corner, const glm::vec2& center, const glm::vec2& delta, float maxTime, float& time, glm::vec2& normal)
+{
+    glm::vec2 offset = center - corner;
+    float b = glm::dot(offset, delta);
+    if (b >= 0.0f)
+        return false; // La balle s'loigne du coin
+
+    float c = glm::dot(offset, offset) - ballRadius * ballRadius;
+    float t = 0.0f;
+    if (c > 0.0f)
+    {
+        float a = glm::dot(delta, delta);
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f)
+            return false;
+
+        t = (-b - std::sqrt(discriminant)) / a;
+        if (t > maxTime)
+            return false;
+    }
+
+    // Contact tangent : la balle frle le coin sans s'en approcher
+    glm::vec2 contactNormal = glm::normalize(offset + delta * t);
+    if (glm::dot(delta, contactNormal) >= -grazingSpeed * glm::length(delta))
+        return false;
+
+    time = t;
+    normal = contactNormal;
+    return true;
+}
+
+bool sweepWall(const WallSegment& wall, const glm::vec2& center, const glm::vec2& delta, float maxTime, float& time, glm::vec2& normal)
+{
+    glm::vec2 wallDirection = wall.end - wall.start;
+    float wallLengthSquared = glm::dot(wallDirection, wallDirection);
+
+    // Face du mur, du ct o se trouve la balle
+    glm::vec2 faceNormal = glm::normalize(glm::vec2(-wallDirection.y, wallDirection.x));
+    float side = glm::dot(center - wall.start, faceNormal);
+    if (side < 0.0f)
+    {
+        faceNormal = -faceNormal;
+        side = -side;
+    }
+
+    float approachSpeed = -glm::dot(delta, faceNormal);
+    if (approachSpeed > grazingSpeed * glm::length(delta))
+    {
+        float t = side > ballRadius ? (side - ballRadius) / approachSpeed : 0.0f;
+        if (t > maxTime)
+            return false;
+
+        // Contact sur la face : aucun coin ne peut tre touch avant
+        float u = glm::dot(center + delta * t - wall.start, wallDirection) / wallLengthSquared;
+        if (u >= 0.0f && u <= 1.0f)
+        {
+            time = t;
+            normal = faceNormal;
+            return true;
+        }
+    }
+
+    // Sinon la balle ne peut toucher que l'un des coins
+    bool hit = sweepCorner(wall.start, center, delta, maxTime, time, normal);
+    float cornerTime;
+    glm::vec2 cornerNormal;
+    if (sweepCorner(wall.end, center, delta, hit ? time : maxTime, cornerTime, cornerNormal) && (!hit || cornerTime < time))
+    {
+        hit = true;
+        time = cornerTime;
+        normal = cornerNormal;
+    }
+    return hit;
+}
+
+bool sweepWalls(const WallSet& walls, const glm::vec2& center, const glm::vec2& delta, float maxTime, const glm::vec2& resolvedNormal, float& time, glm::vec2& normal)
+{
+    // Cases traverses par le centre, dans l'ordre du trajet (Amanatides et Woo). Le rayon de la
+    // balle est dj dans la grille : une case liste tous les murs que le centre peut y toucher
+    glm::vec2 start = (center - walls.origin) / walls.cellSize;
+    glm::vec2 path = delta * maxTime / walls.cellSize;
+    int x = (int)std::floor(start.x);
+    int z = (int)std::floor(start.y);
+    int stepX = path.x > 0.0f ? 1 : -1;
+    int stepZ = path.y > 0.0f ? 1 : -1;
+    int cellCount = std::abs((int)std::floor(start.x + path.x) - x) + std::abs((int)std::floor(start.y + path.y) - z) + 1;
+
+    // Fraction du trajet  laquelle le centre franchit la prochaine ligne de la grille, et entre deux lignes
+    const float never = std::numeric_limits<float>::infinity();
+    float crossX = path.x != 0.0f ? ((path.x > 0.0f ? x + 1 : x) - start.x) / path.x : never;
+    float crossZ = path.y != 0.0f ? ((path.y > 0.0f ? z + 1 : z) - start.y) / path.y : never;
+    float spanX = path.x != 0.0f ? std::abs(1.0f / path.x) : never;
+    float spanZ = path.y != 0.0f ? std::abs(1.0f / path.y) : never;
+
+    float travel = glm::length(delta);
+
+    // Un long mur est list dans plusieurs cases : il n'est test qu'une fois
+    uint32_t tested[maxSweepTestedWalls];
+    int testedCount = 0;
+
+    bool hit = false;
+    time = maxTime;
+    for (int n = 0; n < cellCount; ++n)
+    {
+        if (x >= 0 && z >= 0 && x < walls.width && z < walls.height)
+        {
+            int cell = z * walls.width + x;
+            for (uint32_t i = walls.cellStarts[cell]; i < walls.cellStarts[cell + 1]; ++i)
+            {
+                uint32_t wall = walls.cellItems[i];
+                if (std::find(tested, tested + testedCount, wall) != tested + testedCount)
+                    continue;
+                if (testedCount < maxSweepTestedWalls)
+                    tested[testedCount++] = wall;
+
+                float wallTime;
+                glm::vec2 wallNormal;
+                if (!sweepWall(walls.segments[wall], center, delta, time, wallTime, wallNormal) || (hit && wallTime >= time))
+                    continue;
+
+                if (wallTime * travel < contactSlop && glm::dot(wallNormal, resolvedNormal) > sameContactCosine)
+                    continue; // Contact dj rsolu
+
+                hit = true;
+                time = wallTime;
+                normal = wallNormal;
+            }
+        }
+
+        // Impact avant la sortie de la case : les cases suivantes ne peuvent donner qu'un impact plus tardif
+        float exit = std::min(crossX, crossZ);
+        if (hit && time <= exit * maxTime)
+            break;
+
+        if (crossX < crossZ)
+        {
+            x += stepX;
+            crossX += spanX;
+        }
+        else
+        {
+            z += stepZ;
+            crossZ += spanZ;
+        }
+    }
+    return hit;
+}
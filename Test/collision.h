@@ -0,0 +1,47 @@
+#pragma once
+#include <glm.hpp>
+#include <cstdint>
+
+// Mur vu de dessus, de (x1, z1)  (x2, z2)
+struct WallSegment
+{
+    glm::vec2 start;
+    glm::vec2 end;
+};
+
+// Murs d'un parcours avec leur grille uniforme d'acclration (phase large).
+// Chaque case liste les murs qui peuvent toucher une balle dont le centre est dans la case,
+// une sous-tape ne teste donc que les murs d'une seule case, quel que soit le nombre de murs.
+struct WallSet
+{
+    const WallSegment* segments;
+    const uint32_t* cellStarts; // width * height + 1 entres, indices dans cellItems
+    const uint32_t* cellItems;  // Indices de murs dans segments
+
+    glm::vec2 origin;
+    float cellSize;
+    int width;
+    int height;
+};
+
+const float wallGridCellSize = 4.0f;
+
+// Phase troite : collision sphre / mur dans le plan xz, rflexion de la vitesse le long de la normale
+bool collideWall(const WallSegment& wall, glm::vec3& position, glm::vec3& velocity);
+
+// Teste la balle contre les murs de sa case, retourne le nombre d'impacts
+int collideWalls(const WallSet& walls, glm::vec3& position, glm::vec3& velocity);
+
+// Collision continue : premier instant t de [0, maxTime] o la balle, dont le centre se dplace de
+// center  center + delta * t dans le plan xz, touche le mur en s'en approchant (vitesse le long de
+// la normale de contact ngative, au-del des arrondis : une balle qui glisse le long du mur ne le touche pas).
+// normal reoit la normale de contact (du mur vers la balle).
+bool sweepWall(const WallSegment& wall, const glm::vec2& center, const glm::vec2& delta, float maxTime, float& time, glm::vec2& normal);
+
+// Mme chose contre les murs des cases traverses par le centre, case aprs case le long du trajet.
+// Chaque mur n'est test qu'une fois (jusqu' maxSweepTestedWalls murs distincts par trajet).
+// resolvedNormal est la normale du dernier impact rsolu pendant le pas (vecteur nul au dbut du pas) :
+// un contact immdiat de mme normale (mme face ou mme coin, murs voisins compris) est ignor,
+// la balle vient d'y rebondir et seuls les arrondis de la rflexion la font encore s'en approcher.
+const int maxSweepTestedWalls = 64;
+bool sweepWalls(const WallSet& walls, const glm::vec2& center, const glm::vec2& delta, float maxTime, const glm::vec2& resolvedNormal, float& time, glm::vec2& normal);
@@ -0,0 +1,527 @@
+#include "course.h"
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// En-tte du cache binaire, suivi de : Course[courseCount], float[vertexCount * courseVertexSize],
+// WallSegment[segmentCount], uint32_t[cellStartCount], uint32_t[cellItemCount]
+struct CourseCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceKey;
+    uint32_t courseCount;
+    uint32_t vertexCount;
+    uint32_t segmentCount;
+    uint32_t cellStartCount;
+    uint32_t cellItemCount;
+    uint32_t padding;
+};
+
+static const char courseCacheMagic[4] = { 'G', 'O', 'L', 'F' };
+static const uint32_t courseCacheVersion = 2;
+
+static const glm::vec3 groundColor(0.0f, 1.0f, 0.0f);
+static const glm::vec3 wallColor(0.5f, 0.5f, 0.5f);
+
+static std::string getDirectory(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+static bool readManifest(const char* manifestPath, std::vector<std::string>& files, std::string& contents)
+{
+    std::ifstream manifest(manifestPath, std::ios::in | std::ios::binary);
+    if (!manifest.is_open())
+    {
+        std::cerr << "Impossible d'ouvrir " << manifestPath << std::endl;
+        return false;
+    }
+
+    std::stringstream sstr;
+    sstr << manifest.rdbuf();
+    contents = sstr.str();
+
+    std::string directory = getDirectory(manifestPath);
+    std::istringstream lines(contents);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream words(line);
+        std::string file;
+        if (words >> file)
+            files.push_back(directory + file);
+    }
+
+    if (files.empty())
+    {
+        std::cerr << manifestPath << " : aucun parcours" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Empreinte des sources : contenu du manifeste + taille et date de chaque fichier de parcours.
+// vite de relire les parcours quand le cache est  jour.
+static uint64_t computeSourceKey(const std::string& manifestContents, const std::vector<std::string>& files)
+{
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    auto mix = [&hash](const void* bytes, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    mix(&courseCacheVersion, sizeof(courseCacheVersion));
+    mix(manifestContents.data(), manifestContents.size());
+    for (const std::string& file : files)
+    {
+        struct stat info;
+        int64_t stamp[2] = { -1, -1 };
+        if (stat(file.c_str(), &info) == 0)
+        {
+            stamp[0] = (int64_t)info.st_size;
+            stamp[1] = (int64_t)info.st_mtime;
+        }
+        mix(stamp, sizeof(stamp));
+    }
+    return hash;
+}
+
+static void addVertex(std::vector<float>& vertices, float x, float y, float z, const glm::vec3& color)
+{
+    vertices.push_back(x);
+    vertices.push_back(y);
+    vertices.push_back(z);
+    vertices.push_back(color.r);
+    vertices.push_back(color.g);
+    vertices.push_back(color.b);
+}
+
+// Format texte d'un parcours (une instruction par ligne, # pour les commentaires) :
+//   par <coups>
+//   tee <x> <z>
+//   hole <x> <z>
+//   ground <minX> <minZ> <maxX> <maxZ>
+//   wall <x1> <z1> <x2> <z2>
+static bool parseCourse(const std::string& path, Course& course, std::vector<float>& vertices, std::vector<WallSegment>& segments)
+{
+    std::ifstream file(path, std::ios::in);
+    if (!file.is_open())
+    {
+        std::cerr << "Impossible d'ouvrir " << path << std::endl;
+        return false;
+    }
+
+    course = Course();
+    course.par = 3;
+    course.startPosition = glm::vec3(0.0f, ballRadius, 0.0f);
+
+    std::vector<float> ground;
+    std::vector<float> walls;
+    course.segmentFirst = (uint32_t)segments.size();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream words(line);
+        std::string keyword;
+        if (!(words >> keyword))
+            continue;
+
+        std::vector<float> values;
+        float value;
+        while (words >> value)
+            values.push_back(value);
+
+        size_t expected = 0;
+        if (keyword == "par")
+            expected = 1;
+        else if (keyword == "tee" || keyword == "hole")
+            expected = 2;
+        else if (keyword == "ground" || keyword == "wall")
+            expected = 4;
+
+        if (expected == 0 || values.size() != expected || !words.eof())
+        {
+            std::cerr << path << ":" << lineNumber << " : instruction invalide '" << keyword << "'" << std::endl;
+            return false;
+        }
+
+        if (keyword == "par")
+        {
+            course.par = (int)values[0];
+        }
+        else if (keyword == "tee")
+        {
+            course.startPosition = glm::vec3(values[0], ballRadius, values[1]);
+        }
+        else if (keyword == "hole")
+        {
+            course.holePosition = glm::vec3(values[0], 0.0f, values[1]);
+        }
+        else if (keyword == "ground")
+        {
+            addVertex(ground, values[0], 0.0f, values[1], groundColor);
+            addVertex(ground, values[0], 0.0f, values[3], groundColor);
+            addVertex(ground, values[2], 0.0f, values[3], groundColor);
+            addVertex(ground, values[2], 0.0f, values[1], groundColor);
+        }
+        else if (keyword == "wall")
+        {
+            // Un mur sans longueur n'a pas de direction : la collision diviserait par zro
+            if (values[0] == values[2] && values[1] == values[3])
+            {
+                std::cerr << path << ":" << lineNumber << " : mur de longueur nulle" << std::endl;
+                return false;
+            }
+
+            addVertex(walls, values[0], 0.0f, values[1], wallColor);
+            addVertex(walls, values[0], wallHeight, values[1], wallColor);
+            addVertex(walls, values[2], wallHeight, values[3], wallColor);
+            addVertex(walls, values[2], 0.0f, values[3], wallColor);
+
+            WallSegment segment;
+            segment.start = glm::vec2(values[0], values[1]);
+            segment.end = glm::vec2(values[2], values[3]);
+            segments.push_back(segment);
+        }
+    }
+
+    course.groundFirst = (uint32_t)(vertices.size() / courseVertexSize);
+    course.groundCount = (uint32_t)(ground.size() / courseVertexSize);
+    vertices.insert(vertices.end(), ground.begin(), ground.end());
+
+    course.wallFirst = (uint32_t)(vertices.size() / courseVertexSize);
+    course.wallCount = (uint32_t)(walls.size() / courseVertexSize);
+    vertices.insert(vertices.end(), walls.begin(), walls.end());
+
+    course.segmentCount = (uint32_t)segments.size() - course.segmentFirst;
+    return true;
+}
+
+// Range les murs du parcours dans une grille uniforme : un mur est list dans toutes les cases
+// que sa bote englobante, largie du rayon de la balle, recouvre
+static void buildWallGrid(Course& course, const std::vector<WallSegment>& segments, std::vector<uint32_t>& cellStarts, std::vector<uint32_t>& cellItems)
+{
+    glm::vec2 minimum(0.0f);
+    glm::vec2 maximum(0.0f);
+    for (uint32_t i = 0; i < course.segmentCount; ++i)
+    {
+        const WallSegment& segment = segments[course.segmentFirst + i];
+        glm::vec2 low = glm::min(segment.start, segment.end) - glm::vec2(ballRadius);
+        glm::vec2 high = glm::max(segment.start, segment.end) + glm::vec2(ballRadius);
+        minimum = i == 0 ? low : glm::min(minimum, low);
+        maximum = i == 0 ? high : glm::max(maximum, high);
+    }
+
+    course.gridOrigin = minimum;
+    course.gridCellSize = wallGridCellSize;
+    course.gridWidth = std::max(1u, (uint32_t)std::ceil((maximum.x - minimum.x) / wallGridCellSize));
+    course.gridHeight = std::max(1u, (uint32_t)std::ceil((maximum.y - minimum.y) / wallGridCellSize));
+    course.gridCellFirst = (uint32_t)cellStarts.size();
+
+    std::vector<std::vector<uint32_t>> cells(course.gridWidth * course.gridHeight);
+    for (uint32_t i = 0; i < course.segmentCount; ++i)
+    {
+        const WallSegment& segment = segments[course.segmentFirst + i];
+        glm::vec2 low = (glm::min(segment.start, segment.end) - glm::vec2(ballRadius) - minimum) / wallGridCellSize;
+        glm::vec2 high = (glm::max(segment.start, segment.end) + glm::vec2(ballRadius) - minimum) / wallGridCellSize;
+        uint32_t lastX = std::min(course.gridWidth - 1, (uint32_t)high.x);
+        uint32_t lastZ = std::min(course.gridHeight - 1, (uint32_t)high.y);
+        for (uint32_t z = (uint32_t)low.y; z <= lastZ; ++z)
+        {
+            for (uint32_t x = (uint32_t)low.x; x <= lastX; ++x)
+                cells[z * course.gridWidth + x].push_back(course.segmentFirst + i);
+        }
+    }
+
+    for (const std::vector<uint32_t>& cell : cells)
+    {
+        cellStarts.push_back((uint32_t)cellItems.size());
+        cellItems.insert(cellItems.end(), cell.begin(), cell.end());
+    }
+    cellStarts.push_back((uint32_t)cellItems.size());
+}
+
+static bool compileCourses(const std::vector<std::string>& files, uint64_t sourceKey, const char* cachePath)
+{
+    std::vector<Course> courses(files.size());
+    std::vector<float> vertices;
+    std::vector<WallSegment> segments;
+    std::vector<uint32_t> cellStarts;
+    std::vector<uint32_t> cellItems;
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!parseCourse(files[i], courses[i], vertices, segments))
+            return false;
+
+        buildWallGrid(courses[i], segments, cellStarts, cellItems);
+    }
+
+    CourseCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, courseCacheMagic, sizeof(header.magic));
+    header.version = courseCacheVersion;
+    header.sourceKey = sourceKey;
+    header.courseCount = (uint32_t)courses.size();
+    header.vertexCount = (uint32_t)(vertices.size() / courseVertexSize);
+    header.segmentCount = (uint32_t)segments.size();
+    header.cellStartCount = (uint32_t)cellStarts.size();
+    header.cellItemCount = (uint32_t)cellItems.size();
+
+    std::ofstream cache(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!cache.is_open())
+    {
+        std::cerr << "Impossible d'crire " << cachePath << std::endl;
+        return false;
+    }
+
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    cache.write(reinterpret_cast<const char*>(courses.data()), courses.size() * sizeof(Course));
+    cache.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+    cache.write(reinterpret_cast<const char*>(segments.data()), segments.size() * sizeof(WallSegment));
+    cache.write(reinterpret_cast<const char*>(cellStarts.data()), cellStarts.size() * sizeof(uint32_t));
+    cache.write(reinterpret_cast<const char*>(cellItems.data()), cellItems.size() * sizeof(uint32_t));
+    return cache.good();
+}
+
+bool compileCourses(const char* manifestPath, const char* cachePath)
+{
+    std::vector<std::string> files;
+    std::string manifestContents;
+    if (!readManifest(manifestPath, files, manifestContents))
+        return false;
+
+    return compileCourses(files, computeSourceKey(manifestContents, files), cachePath);
+}
+
+std::string getCourseCachePath(const char* manifestPath)
+{
+    std::string cachePath = manifestPath;
+    size_t dot = cachePath.find_last_of('.');
+    if (dot != std::string::npos && cachePath.find_first_of("/\\", dot) == std::string::npos)
+        cachePath.erase(dot);
+    return cachePath + ".bin";
+}
+
+CourseLibrary::CourseLibrary()
+{
+    data = nullptr;
+    dataSize = 0;
+    mapping = nullptr;
+    courseTable = nullptr;
+    courseCount = 0;
+    vertices = nullptr;
+    vertexCount = 0;
+    segments = nullptr;
+    segmentCount = 0;
+    cellStarts = nullptr;
+    cellItems = nullptr;
+}
+
+CourseLibrary::~CourseLibrary()
+{
+    unload();
+}
+
+bool CourseLibrary::load(const char* manifestPath, const char* cachePath)
+{
+    unload();
+
+    std::vector<std::string> files;
+    std::string manifestContents;
+    if (!readManifest(manifestPath, files, manifestContents))
+        return false;
+
+    uint64_t sourceKey = computeSourceKey(manifestContents, files);
+    if (mapCache(cachePath, sourceKey))
+        return true;
+
+    // Cache absent ou prim : recompiler puis projeter  nouveau
+    std::cout << "Compilation des parcours: " << manifestPath << std::endl;
+    if (!compileCourses(files, sourceKey, cachePath))
+        return false;
+
+    return mapCache(cachePath, sourceKey);
+}
+
+bool CourseLibrary::load(const char* manifestPath)
+{
+    return load(manifestPath, getCourseCachePath(manifestPath).c_str());
+}
+
+bool CourseLibrary::mapCache(const char* cachePath, uint64_t sourceKey)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(cachePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE fileMapping = size.QuadPart > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(file);
+    if (fileMapping == NULL)
+        return false;
+
+    data = static_cast<const unsigned char*>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        CloseHandle(fileMapping);
+        return false;
+    }
+    mapping = fileMapping;
+    dataSize = (size_t)size.QuadPart;
+#else
+    int file = open(cachePath, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED)
+        return false;
+
+    data = static_cast<const unsigned char*>(view);
+    dataSize = (size_t)info.st_size;
+#endif
+
+    const CourseCacheHeader* header = reinterpret_cast<const CourseCacheHeader*>(data);
+    size_t expectedSize = sizeof(CourseCacheHeader);
+    if (dataSize >= sizeof(CourseCacheHeader))
+    {
+        expectedSize += header->courseCount * sizeof(Course)
+            + (size_t)header->vertexCount * courseVertexSize * sizeof(float)
+            + header->segmentCount * sizeof(WallSegment)
+            + ((size_t)header->cellStartCount + header->cellItemCount) * sizeof(uint32_t);
+    }
+
+    if (dataSize < sizeof(CourseCacheHeader) || dataSize != expectedSize
+        || std::memcmp(header->magic, courseCacheMagic, sizeof(header->magic)) != 0
+        || header->version != courseCacheVersion || header->sourceKey != sourceKey)
+    {
+        unload();
+        return false;
+    }
+
+    courseTable = reinterpret_cast<const Course*>(data + sizeof(CourseCacheHeader));
+    courseCount = (int)header->courseCount;
+    vertices = reinterpret_cast<const float*>(courseTable + courseCount);
+    vertexCount = header->vertexCount;
+    segments = reinterpret_cast<const WallSegment*>(vertices + (size_t)vertexCount * courseVertexSize);
+    segmentCount = header->segmentCount;
+    cellStarts = reinterpret_cast<const uint32_t*>(segments + segmentCount);
+    cellItems = cellStarts + header->cellStartCount;
+    return true;
+}
+
+void CourseLibrary::unload()
+{
+    if (data != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mapping));
+#else
+        munmap(const_cast<unsigned char*>(data), dataSize);
+#endif
+    }
+
+    data = nullptr;
+    dataSize = 0;
+    mapping = nullptr;
+    courseTable = nullptr;
+    courseCount = 0;
+    vertices = nullptr;
+    vertexCount = 0;
+    segments = nullptr;
+    segmentCount = 0;
+    cellStarts = nullptr;
+    cellItems = nullptr;
+}
+
+int CourseLibrary::getCourseCount() const
+{
+    return courseCount;
+}
+
+const Course& CourseLibrary::getCourse(int index) const
+{
+    return courseTable[index];
+}
+
+const float* CourseLibrary::getVertices() const
+{
+    return vertices;
+}
+
+uint32_t CourseLibrary::getVertexCount() const
+{
+    return vertexCount;
+}
+
+const WallSegment* CourseLibrary::getWallSegments() const
+{
+    return segments;
+}
+
+uint32_t CourseLibrary::getWallSegmentCount() const
+{
+    return segmentCount;
+}
+
+WallSet CourseLibrary::getWalls(int index) const
+{
+    const Course& course = courseTable[index];
+
+    WallSet walls;
+    walls.segments = segments;
+    walls.cellStarts = cellStarts + course.gridCellFirst;
+    walls.cellItems = cellItems;
+    walls.origin = course.gridOrigin;
+    walls.cellSize = course.gridCellSize;
+    walls.width = (int)course.gridWidth;
+    walls.height = (int)course.gridHeight;
+    return walls;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <glm.hpp>
+#include <cstdint>
+#include <string>
+#include "collision.h"
+
+// Un parcours tel qu'il est stock dans le cache binaire : la structure est lue directement
+// dans le fichier projet en mmoire, sans aucune analyse au chargement.
+struct Course
+{
+    int par;
+    glm::vec3 startPosition; // Position de dpart de la balle
+    glm::vec3 holePosition;  // Position du trou (au sol)
+
+    uint32_t groundFirst;    // Premier sommet du sol dans CourseLibrary::getVertices()
+    uint32_t groundCount;    // Nombre de sommets du sol (quads)
+    uint32_t wallFirst;
+    uint32_t wallCount;
+    uint32_t segmentFirst;   // Premier segment de mur dans CourseLibrary::getWallSegments()
+    uint32_t segmentCount;
+
+    glm::vec2 gridOrigin;    // Grille uniforme des murs (voir WallSet)
+    float gridCellSize;
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t gridCellFirst;  // Premire case dans la table des cases du cache
+};
+
+const int courseVertexSize = 6; // Position (3) + couleur (3) par sommet
+const float wallHeight = 2.0f;
+
+const char* const defaultCourseManifest = "courses/courses.txt";
+
+// Compile les parcours lists dans le manifeste en un seul fichier binaire
+bool compileCourses(const char* manifestPath, const char* cachePath);
+std::string getCourseCachePath(const char* manifestPath); // Manifeste avec l'extension .bin
+
+class CourseLibrary
+{
+
+public:
+
+    CourseLibrary();
+    ~CourseLibrary();
+
+    // Projette le cache en mmoire, aprs l'avoir recompil s'il est absent ou prim
+    bool load(const char* manifestPath, const char* cachePath);
+    bool load(const char* manifestPath); // Cache  ct du manifeste, en .bin
+    void unload();
+
+    int getCourseCount() const;
+    const Course& getCourse(int index) const;
+
+    const float* getVertices() const; // courseVertexSize flottants par sommet
+    uint32_t getVertexCount() const;
+    const WallSegment* getWallSegments() const;
+    uint32_t getWallSegmentCount() const;
+    WallSet getWalls(int index) const; // Murs et grille d'un parcours
+
+private:
+
+    const unsigned char* data;
+    size_t dataSize;
+    void* mapping; // Handle de projection (Windows uniquement)
+
+    const Course* courseTable;
+    int courseCount;
+    const float* vertices;
+    uint32_t vertexCount;
+    const WallSegment* segments;
+    uint32_t segmentCount;
+    const uint32_t* cellStarts;
+    const uint32_t* cellItems;
+
+    CourseLibrary(const CourseLibrary&) = delete;
+    CourseLibrary& operator=(const CourseLibrary&) = delete;
+
+    bool mapCache(const char* cachePath, uint64_t sourceKey);
+};
@@ -0,0 +1,51 @@
+#include "frustum.h"
+
+void Frustum::update(const glm::mat4& viewProjection, const glm::vec3& position, float scale)
+{
+    // Gribb et Hartmann : chaque plan est une combinaison de la dernire ligne et d'une autre ligne
+    glm::mat4 m = glm::transpose(viewProjection);
+    planes[0] = m[3] + m[0]; // Gauche
+    planes[1] = m[3] - m[0]; // Droite
+    planes[2] = m[3] + m[1]; // Bas
+    planes[3] = m[3] - m[1]; // Haut
+    planes[4] = m[3] + m[2]; // Proche
+    planes[5] = m[3] - m[2]; // Lointain
+
+    for (glm::vec4& plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    cameraPosition = position;
+    projectionScale = scale;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const
+{
+    for (const glm::vec4& plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+float Frustum::getProjectedRadius(const glm::vec3& center, float radius) const
+{
+    return getProjectedRadius(center, 0.0f, radius);
+}
+
+float Frustum::getProjectedRadius(const glm::vec3& center, float spread, float radius) const
+{
+    float distance = glm::length(center - cameraPosition) - spread;
+    if (distance <= radius)
+        return projectionScale; // Camra dans la sphre : dtail maximal
+    return radius * projectionScale / distance;
+}
+
+int selectLod(const MeshLod* lods, int lodCount, float projectedRadius)
+{
+    // Un segment mesure 2 pi r / n pixels : n >= r le garde sous 6 pixels environ
+    int lod = 0;
+    while (lod + 1 < lodCount && lods[lod + 1].segments >= projectedRadius)
+        ++lod;
+    return lod;
+}
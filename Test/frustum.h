@@ -0,0 +1,43 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm.hpp>
+
+// limination des objets hors champ et choix du niveau de dtail des maillages.
+// Les objets sont approchs par des sphres englobantes.
+
+class Frustum
+{
+
+public:
+
+    // Plans extraits de projection * view, normales vers l'intrieur
+    void update(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float projectionScale);
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+    // Rayon  l'cran, en pixels, d'une sphre de rayon radius centre en center
+    float getProjectedRadius(const glm::vec3& center, float radius) const;
+
+    // Mme chose pour la plus proche de plusieurs sphres de rayon radius dont les centres sont
+    //  moins de spread de center
+    float getProjectedRadius(const glm::vec3& center, float spread, float radius) const;
+
+private:
+
+    glm::vec4 planes[6];
+    glm::vec3 cameraPosition;
+    float projectionScale; // Hauteur du framebuffer / (2 tan(fov / 2))
+};
+
+// Un niveau de dtail dans les tampons d'un maillage
+struct MeshLod
+{
+    int segments;           // Secteurs autour de l'axe
+    GLint baseVertex;       // Premier sommet (ou premier sommet de glDrawArrays)
+    GLuint firstIndex;
+    GLsizei count;          // Indices, ou sommets pour un maillage non index
+};
+
+// Niveau le plus grossier dont les segments restent courts  l'cran (environ 6 pixels) ;
+// les niveaux sont rangs du plus fin au plus grossier
+int selectLod(const MeshLod* lods, int lodCount, float projectedRadius);
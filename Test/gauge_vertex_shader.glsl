@@ -5,11 +5,18 @@ layout (location = 1) in vec3 aColor;
 out vec3 ourColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = screenProjection * model * vec4(aPos, 1.0);
     ourColor = aColor;
 }
@@ -0,0 +1,99 @@
+#include "gl_resource.h"
+#include <sstream>
+
+GlResourceRegistry glResources;
+
+GlResourceRegistry::GlResourceRegistry()
+{
+    for (GlResourceStats& kindStats : stats)
+        kindStats = GlResourceStats{ 0, 0, 0, 0 };
+}
+
+void GlResourceRegistry::onCreate(GlResourceKind kind)
+{
+    ++stats[kind].count;
+    ++stats[kind].created;
+}
+
+void GlResourceRegistry::onDelete(GlResourceKind kind, size_t bytes)
+{
+    --stats[kind].count;
+    ++stats[kind].deleted;
+    stats[kind].bytes -= bytes;
+}
+
+void GlResourceRegistry::onResize(GlResourceKind kind, size_t oldBytes, size_t newBytes)
+{
+    stats[kind].bytes = stats[kind].bytes - oldBytes + newBytes;
+}
+
+const GlResourceStats& GlResourceRegistry::getStats(GlResourceKind kind) const
+{
+    return stats[kind];
+}
+
+int GlResourceRegistry::getTotalCount() const
+{
+    int count = 0;
+    for (const GlResourceStats& kindStats : stats)
+        count += kindStats.count;
+    return count;
+}
+
+size_t GlResourceRegistry::getTotalBytes() const
+{
+    size_t bytes = 0;
+    for (const GlResourceStats& kindStats : stats)
+        bytes += kindStats.bytes;
+    return bytes;
+}
+
+std::string GlResourceRegistry::getReport() const
+{
+    std::ostringstream report;
+    for (int kind = 0; kind < glResourceKindCount; ++kind)
+    {
+        const GlResourceStats& kindStats = stats[kind];
+        report << getGlResourceName((GlResourceKind)kind) << " : " << kindStats.count << " vivants, "
+            << kindStats.bytes / 1024.0 << " Ko (" << kindStats.created << " crs, " << kindStats.deleted << " supprims)\n";
+    }
+    return report.str();
+}
+
+const char* getGlResourceName(GlResourceKind kind)
+{
+    switch (kind)
+    {
+    case GlBufferKind: return "Tampons";
+    case GlVertexArrayKind: return "VAO";
+    case GlProgramKind: return "Programmes";
+    case GlTextureKind: return "Textures";
+    default: return "?";
+    }
+}
+
+GLuint createGlObject(GlResourceKind kind)
+{
+    GLuint id = 0;
+    switch (kind)
+    {
+    case GlBufferKind: glGenBuffers(1, &id); break;
+    case GlVertexArrayKind: glGenVertexArrays(1, &id); break;
+    case GlProgramKind: id = glCreateProgram(); break;
+    case GlTextureKind: glGenTextures(1, &id); break;
+    default: break;
+    }
+    return id;
+}
+
+void deleteGlObject(GlResourceKind kind, GLuint id)
+{
+    switch (kind)
+    {
+    case GlBufferKind: glDeleteBuffers(1, &id); break;
+    case GlVertexArrayKind: glDeleteVertexArrays(1, &id); break;
+    case GlProgramKind: glDeleteProgram(id); break;
+    case GlTextureKind: glDeleteTextures(1, &id); break;
+    default: break;
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <string>
+
+// Objets OpenGL possds par des poignes RAII (dplaables, non copiables) : chaque objet a un
+// seul propritaire, supprim une seule fois. Le registre glResources compte les objets vivants
+// et leur taille par type ; une croissance d'un parcours  l'autre est une fuite (voir
+// golf_headless --leak-check).
+//
+//     GlBuffer vbo;
+//     vbo.create();
+//     glBindBuffer(GL_ARRAY_BUFFER, vbo);
+//     glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+//     vbo.setByteSize(size);
+//
+// Le contexte doit encore tre courant quand une poigne est libre : les poignes globales
+// sont libres explicitement (releaseScene()) avant de dtruire le contexte.
+
+enum GlResourceKind
+{
+    GlBufferKind,
+    GlVertexArrayKind,
+    GlProgramKind,
+    GlTextureKind,
+    glResourceKindCount
+};
+
+struct GlResourceStats
+{
+    int count;          // Objets vivants
+    size_t bytes;       // Mmoire dclare par setByteSize()
+    int created;        // Depuis le dmarrage
+    int deleted;
+};
+
+class GlResourceRegistry
+{
+
+public:
+
+    GlResourceRegistry();
+
+    void onCreate(GlResourceKind kind);
+    void onDelete(GlResourceKind kind, size_t bytes);
+    void onResize(GlResourceKind kind, size_t oldBytes, size_t newBytes);
+
+    const GlResourceStats& getStats(GlResourceKind kind) const;
+    int getTotalCount() const;
+    size_t getTotalBytes() const;
+    std::string getReport() const; // Une ligne par type
+
+private:
+
+    GlResourceStats stats[glResourceKindCount];
+};
+
+extern GlResourceRegistry glResources;
+
+const char* getGlResourceName(GlResourceKind kind);
+GLuint createGlObject(GlResourceKind kind);
+void deleteGlObject(GlResourceKind kind, GLuint id);
+
+template <GlResourceKind Kind>
+class GlHandle
+{
+
+public:
+
+    GlHandle() : id(0), bytes(0) {}
+    ~GlHandle() { reset(); }
+
+    GlHandle(const GlHandle&) = delete;
+    GlHandle& operator=(const GlHandle&) = delete;
+
+    GlHandle(GlHandle&& other) : id(other.id), bytes(other.bytes)
+    {
+        other.id = 0;
+        other.bytes = 0;
+    }
+
+    GlHandle& operator=(GlHandle&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            id = other.id;
+            bytes = other.bytes;
+            other.id = 0;
+            other.bytes = 0;
+        }
+        return *this;
+    }
+
+    // Remplace l'objet possd par un nouveau
+    void create()
+    {
+        reset();
+        id = createGlObject(Kind);
+        glResources.onCreate(Kind);
+    }
+
+    // Prend possession d'un objet cr ailleurs (programmes du cache de shaders)
+    void adopt(GLuint object)
+    {
+        reset();
+        id = object;
+        if (id)
+            glResources.onCreate(Kind);
+    }
+
+    void reset()
+    {
+        if (!id)
+            return;
+        deleteGlObject(Kind, id);
+        glResources.onDelete(Kind, bytes);
+        id = 0;
+        bytes = 0;
+    }
+
+    // Taille du stockage aprs glBufferData / glTexImage2D, pour le registre
+    void setByteSize(size_t size)
+    {
+        glResources.onResize(Kind, bytes, size);
+        bytes = size;
+    }
+
+    GLuint get() const { return id; }
+    operator GLuint() const { return id; }
+    size_t getByteSize() const { return bytes; }
+
+private:
+
+    GLuint id;
+    size_t bytes;
+};
+
+typedef GlHandle<GlBufferKind> GlBuffer;
+typedef GlHandle<GlVertexArrayKind> GlVertexArray;
+typedef GlHandle<GlProgramKind> GlProgram;
+typedef GlHandle<GlTextureKind> GlTexture;
@@ -0,0 +1,97 @@
+#include "gpu_profiler.h"
+
+#ifdef GOLF_PROFILE
+
+GpuProfiler gpuProfiler;
+
+GpuProfiler::GpuProfiler()
+    : activeSection(-1), nestedScopes(0), droppedCount(0)
+{
+}
+
+bool GpuProfiler::read(GpuQuery& query)
+{
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &elapsed);
+    query.pending = false;
+    profiler.addSample(query.section, elapsed / 1.0e6, query.frame);
+    return true;
+}
+
+void GpuProfiler::begin(int section)
+{
+    if (activeSection >= 0)
+    {
+        ++nestedScopes; // Dj compt dans la section ouverte
+        return;
+    }
+    if (section < 0)
+        return;
+
+    // Requtes cres au premier usage, quand le contexte existe
+    if (queries.empty())
+    {
+        queries.resize(gpuQueryFrames * maxProfileSections);
+        for (GpuQuery& query : queries)
+        {
+            glGenQueries(1, &query.query);
+            query.pending = false;
+        }
+    }
+
+    int64_t frame = profiler.getFrameIndex();
+    GpuQuery& query = queries[(size_t)(frame % gpuQueryFrames) * maxProfileSections + section];
+    if (query.pending && !read(query))
+    {
+        ++droppedCount; // Le GPU a plus de gpuQueryFrames images de retard
+        return;
+    }
+
+    query.section = section;
+    query.frame = frame;
+    query.pending = true;
+    glBeginQuery(GL_TIME_ELAPSED, query.query);
+    activeSection = section;
+}
+
+void GpuProfiler::end()
+{
+    if (nestedScopes > 0)
+    {
+        --nestedScopes;
+        return;
+    }
+    if (activeSection < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    activeSection = -1;
+}
+
+void GpuProfiler::collect()
+{
+    for (GpuQuery& query : queries)
+    {
+        if (query.pending)
+            read(query);
+    }
+}
+
+void GpuProfiler::release()
+{
+    for (GpuQuery& query : queries)
+        glDeleteQueries(1, &query.query);
+    queries.clear();
+}
+
+int GpuProfiler::getDroppedCount() const
+{
+    return droppedCount;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <GL/glew.h>
+#include "profiler.h"
+
+// Temps GPU des sections PROFILE_GPU, mesurs par des requtes GL_TIME_ELAPSED. Chaque section
+// a une requte par image sur gpuQueryFrames images : un rsultat n'est lu que lorsque le pilote
+// le signale disponible, le CPU n'attend donc jamais le GPU. Si une requte est encore en vol
+// quand son emplacement revient, la mesure de cette image est abandonne.
+
+#ifdef GOLF_PROFILE
+
+#include <vector>
+
+const int gpuQueryFrames = 4;
+
+class GpuProfiler
+{
+
+public:
+
+    GpuProfiler();
+
+    // GL_TIME_ELAPSED ne s'imbrique pas : une section ouverte dans une autre n'est pas mesure
+    void begin(int section);
+    void end();
+    void collect(); // Transmet au profileur les rsultats arrivs, une fois par image
+    void release(); // Supprime les requtes, avant de dtruire le contexte
+
+    int getDroppedCount() const;
+
+private:
+
+    struct GpuQuery
+    {
+        GLuint query;
+        int section;
+        int64_t frame;      // Image mesure
+        bool pending;       // Rsultat pas encore lu
+    };
+
+    std::vector<GpuQuery> queries; // gpuQueryFrames * maxProfileSections emplacements
+    int activeSection;
+    int nestedScopes;
+    int droppedCount;
+
+    bool read(GpuQuery& query);
+};
+
+extern GpuProfiler gpuProfiler;
+
+class GpuProfileScope
+{
+
+public:
+
+    explicit GpuProfileScope(int section) { gpuProfiler.begin(section); }
+    ~GpuProfileScope() { gpuProfiler.end(); }
+};
+
+#define PROFILE_GPU(name) \
+    static const int GOLF_PROFILE_JOIN(profileGpuSection, __LINE__) = profiler.getSection(name, true); \
+    GpuProfileScope GOLF_PROFILE_JOIN(profileGpuScope, __LINE__)(GOLF_PROFILE_JOIN(profileGpuSection, __LINE__))
+
+#define PROFILE_GPU_COLLECT() gpuProfiler.collect()
+
+#else
+
+#define PROFILE_GPU(name)
+#define PROFILE_GPU_COLLECT()
+
+#endif
@@ -0,0 +1,171 @@
+#include "input_queue.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+const size_t maxLatencyFrames = 1 << 20; // Au-del, le CSV n'est plus complt (environ 24 Mo)
+
+InputQueue::InputQueue()
+    : next(0)
+{
+}
+
+void InputQueue::push(const InputEvent& event)
+{
+    events.push_back(event);
+}
+
+bool InputQueue::pop(InputEvent& event)
+{
+    if (next == events.size())
+    {
+        // File vide : on rutilise la mmoire pour les images suivantes
+        events.clear();
+        next = 0;
+        return false;
+    }
+    event = events[next++];
+    return true;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : count(0), sum(0.0), max(0.0)
+{
+    std::fill(buckets, buckets + latencyBucketCount, 0);
+}
+
+void LatencyHistogram::add(double milliseconds)
+{
+    int bucket = std::min(latencyBucketCount - 1, std::max(0, (int)(milliseconds / latencyBucketWidth)));
+    ++buckets[bucket];
+    ++count;
+    sum += milliseconds;
+    max = std::max(max, milliseconds);
+}
+
+int LatencyHistogram::getCount() const
+{
+    return count;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return count > 0 ? sum / count : 0.0;
+}
+
+double LatencyHistogram::getMax() const
+{
+    return max;
+}
+
+double LatencyHistogram::getPercentile(float ratio) const
+{
+    int rank = (int)(ratio * count + 0.5f);
+    int seen = 0;
+    for (int bucket = 0; bucket < latencyBucketCount; ++bucket)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank && seen > 0)
+            return std::min((bucket + 1) * latencyBucketWidth, max);
+    }
+    return 0.0;
+}
+
+std::string LatencyHistogram::getReport(const char* title) const
+{
+    char line[128];
+    std::snprintf(line, sizeof(line), "%s : %d mesures, moy. %.2f ms, p50 %.0f ms, p90 %.0f ms, p99 %.0f ms, max %.2f ms\n",
+        title, count, getMean(), getPercentile(0.5f), getPercentile(0.9f), getPercentile(0.99f), max);
+    std::string report = line;
+
+    int largest = *std::max_element(buckets, buckets + latencyBucketCount);
+    for (int bucket = 0; bucket < latencyBucketCount; ++bucket)
+    {
+        if (buckets[bucket] == 0)
+            continue;
+        int width = std::max(1, buckets[bucket] * 50 / largest);
+        std::snprintf(line, sizeof(line), "  %3.0f-%s ms %6d ", bucket * latencyBucketWidth,
+            bucket + 1 < latencyBucketCount ? std::to_string((int)((bucket + 1) * latencyBucketWidth)).c_str() : "", buckets[bucket]);
+        report += line;
+        report += std::string(width, '#') + "\n";
+    }
+    return report;
+}
+
+LatencyMonitor::LatencyMonitor()
+    : enabled(false), inputPending(false), oldestInput(0.0), lastPresent(-1.0)
+{
+}
+
+void LatencyMonitor::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
+bool LatencyMonitor::isEnabled() const
+{
+    return enabled;
+}
+
+void LatencyMonitor::onInput(double time)
+{
+    if (enabled && !inputPending)
+    {
+        inputPending = true;
+        oldestInput = time;
+    }
+}
+
+void LatencyMonitor::onPresent(double time)
+{
+    if (!enabled)
+        return;
+
+    FrameLatency frame = { time, 0.0, -1.0 };
+    if (lastPresent >= 0.0)
+    {
+        frame.frameInterval = (time - lastPresent) * 1000.0;
+        frameInterval.add(frame.frameInterval);
+    }
+    if (inputPending)
+    {
+        frame.inputLatency = (time - oldestInput) * 1000.0;
+        inputLatency.add(frame.inputLatency);
+        inputPending = false;
+    }
+    lastPresent = time;
+
+    if (frames.size() < maxLatencyFrames)
+        frames.push_back(frame);
+}
+
+const LatencyHistogram& LatencyMonitor::getInputLatency() const
+{
+    return inputLatency;
+}
+
+const LatencyHistogram& LatencyMonitor::getFrameInterval() const
+{
+    return frameInterval;
+}
+
+bool LatencyMonitor::writeCsv(const char* path) const
+{
+    std::ofstream csv(path);
+    if (!csv.is_open())
+    {
+        std::cerr << "Impossible d'crire " << path << std::endl;
+        return false;
+    }
+
+    csv << "frame,present_s,frame_interval_ms,input_latency_ms\n";
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        csv << i << "," << frames[i].presentTime << "," << frames[i].frameInterval << ",";
+        if (frames[i].inputLatency >= 0.0)
+            csv << frames[i].inputLatency;
+        csv << "\n";
+    }
+    return csv.good();
+}
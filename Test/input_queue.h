@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Entres horodates. Les rappels GLFW ne font que dposer les vnements, dats au moment o
+// glfwPollEvents() les livre. La boucle de jeu les traite ensuite dans l'ordre : la dure d'appui
+// sur E vient de ces dates et non plus des dures d'images.
+//
+// Avec --latency, LatencyMonitor mesure pour chaque image le dlai entre la plus ancienne entre
+// qu'elle prend en compte et sa prsentation. Il garde aussi l'intervalle entre deux prsentations,
+// pour rgler l'intervalle de synchronisation (--swap-interval)  partir de mesures.
+
+struct InputEvent
+{
+    int key;        // GLFW_KEY_*
+    int action;     // GLFW_PRESS, GLFW_RELEASE ou GLFW_REPEAT
+    double time;    // glfwGetTime()  la rception
+};
+
+class InputQueue
+{
+
+public:
+
+    InputQueue();
+
+    void push(const InputEvent& event);
+    bool pop(InputEvent& event); // Dans l'ordre d'arrive, false quand la file est vide
+
+private:
+
+    std::vector<InputEvent> events;
+    size_t next;
+};
+
+const double latencyBucketWidth = 1.0;  // ms
+const int latencyBucketCount = 100;     // La dernire case reoit tout ce qui dpasse
+
+class LatencyHistogram
+{
+
+public:
+
+    LatencyHistogram();
+
+    void add(double milliseconds);
+
+    int getCount() const;
+    double getMean() const;
+    double getMax() const;
+    double getPercentile(float ratio) const; // Borne haute de la case atteinte, au plus le maximum (ms)
+    std::string getReport(const char* title) const; // Rsum et une barre par case non vide
+
+private:
+
+    int buckets[latencyBucketCount];
+    int count;
+    double sum;
+    double max;
+};
+
+// Une ligne du CSV de --latency
+struct FrameLatency
+{
+    double presentTime;     // s
+    double frameInterval;   // ms depuis la prsentation prcdente
+    double inputLatency;    // ms, ngatif si l'image n'avait aucune nouvelle entre
+};
+
+class LatencyMonitor
+{
+
+public:
+
+    LatencyMonitor();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    void onInput(double time);      // Toute entre qui change l'image (touches, souris)
+    void onPresent(double time);    // Aprs la prsentation de l'image
+
+    const LatencyHistogram& getInputLatency() const;
+    const LatencyHistogram& getFrameInterval() const;
+    bool writeCsv(const char* path) const;
+
+private:
+
+    bool enabled;
+    bool inputPending;
+    double oldestInput;     // Premire entre pas encore prsente
+    double lastPresent;
+    LatencyHistogram inputLatency;
+    LatencyHistogram frameInterval;
+    std::vector<FrameLatency> frames;
+};
@@ -2,12 +2,17 @@
 #include <GLFW/glfw3.h>
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
-#include <gtc/type_ptr.hpp>
+#include <cstdlib>
 #include <iostream>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <string>
+#include "course.h"
+#include "gpu_profiler.h"
+#include "input_queue.h"
+#include "physics.h"
+#include "physics_thread.h"
+#include "replay.h"
+#include "scene.h"
 
 GLFWwindow* window;
 float angleX = 0.0f;
@@ -17,44 +22,47 @@ double lastX = 400.0;
 double lastY = 300.0;
 const float sensitivity = 0.005f; // Sensibilit de la souris
 
-GLuint sphereVAO, sphereVBO, groundVAO, groundVBO, wallVAO, wallVBO;
-GLuint cylinderVAO, cylinderVBO, cylinderEBO;
-GLuint circleVAO, circleVBO;
-GLuint powerGaugeVAO, powerGaugeVBO;
-GLuint flagVAO, flagVBO;
-GLuint shaderProgram, ballShaderProgram, circleShaderProgram, poleShaderProgram, flagShaderProgram, gaugeShaderProgram, trailShaderProgram; // Shaders
-
-const int sectorCount = 36;
-const int stackCount = 18;
-const float radius = 0.6f;
-const float dampingFactor = 0.8f;
-const float gravity = 0.005f;
-const float minBounceSpeed = 0.001f;
-const float friction = 0.995f; // Friction
-const int subSteps = 10; // Nombre de sous-tapes pour la simulation
 const float rotationSpeedFactor = 50.0f; // Facteur de vitesse de rotation
 
-double keyPressDuration = 0.0;
+double keyPressDuration = 0.0; // Dure d'appui sur E affiche par la jauge
 const double maxKeyPressDuration = 3.0;
-const float maxImpulseStrength = 2.0f;
+bool shotKeyHeld = false;
+double shotKeyPressTime = 0.0; // Date de l'vnement d'appui sur E
 double lastShotTime = -2.0; // Initialise  -2 pour permettre le premier tir immdiatement
 const double shotCooldown = 2.0; // Temps de rcupration en secondes
 double lastTime = glfwGetTime();
 double endTime = 0.0;
 bool showEndText = false;
-int numShots = 0; // Nombre de tirs
-
-const int maxTrailLength = 50; // Longueur maximale de la trane
-std::vector<glm::vec3> trailPositions; // Vecteur pour stocker les positions de la trane
+int numShots = 0; // Nombre de tirs sur le parcours en cours
+int holeShots = 0; // Nombre de tirs du dernier parcours termin, pour le message de fin
+double fpsTime = 0.0; // Dbut de la priode de mesure des images par seconde
+int fpsFrames = 0;
+double framesPerSecond = 0.0;
 
 const double levelTransitionDelay = 0.0; // Dlai avant la transition vers le niveau suivant
 bool levelTransition = false; // Drapeau pour indiquer la transition de niveau
 
-glm::vec3 initialSpherePosition(0.0f, radius, 0.0f); // Position initiale au sol
-glm::vec3 spherePosition = initialSpherePosition;
-glm::vec3 sphereVelocity(0.0f, 0.0f, 0.0f);
+CourseLibrary courses; // Parcours chargs depuis le cache binaire (courses/courses.bin)
+Physics physics; // Simulation de la balle (position, vitesse, collisions),  physicsThread pendant la partie
+PhysicsThread physicsThread; // Pas fixes sur un thread spar, entres par file et tat par instantans
+BallState displayedBall = {}; // Interpole entre les deux derniers instantans, pour l'image en cours
+unsigned int displayedCourseLoads = 0; // Chargements de parcours dj affichs
+ReplayRecorder recorder; // Enregistrement des entres (--record)
+ReplayPlayer player; // Relecture d'un enregistrement (--replay), les entres du joueur sont alors ignores
+const char* replayPath = nullptr; // Charg par init(), une fois les parcours connus
+int trailLengthOption = 0; // Longueur de la trane (--trail), 0 pour la valeur par dfaut
+int swapIntervalOption = -1; // Intervalle de synchronisation verticale (--swap-interval), -1 pour celui du pilote
+InputQueue inputQueue; // Touches dposes par key_callback, traites par la boucle de jeu
+LatencyMonitor latencyMonitor; // Latence entre-prsentation (--latency)
+const char* latencyCsvPath = nullptr;
 glm::mat4 ballRotation = glm::mat4(1.0f); // Matrice de rotation initiale pour la balle
 
+#ifdef GOLF_PROFILE
+const char* profileTracePath = nullptr; // --profile-trace : Chrome trace crite en quittant
+const char* profileCsvPath = nullptr; // --profile-csv : temps de chaque section, image par image
+#endif
+
+bool cameraChanged = true; // Camra  enregistrer (--record) ; true pour enregistrer la vue de dpart
 bool cursorLocked = true;
 int currentCourse = 0; // Variable pour suivre le parcours actuel
 
@@ -65,12 +73,16 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 {
+    if (latencyMonitor.isEnabled())
+        latencyMonitor.onInput(glfwGetTime());
+
     double deltaX = xpos - lastX;
     double deltaY = ypos - lastY;
     angleY += deltaX * sensitivity;
     angleX += deltaY * sensitivity;
     lastX = xpos;
     lastY = ypos;
+    cameraChanged = true;
 
     if (angleX > glm::radians(89.0f))
         angleX = glm::radians(89.0f);
@@ -80,405 +92,79 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
+    if (latencyMonitor.isEnabled())
+        latencyMonitor.onInput(glfwGetTime());
+
     zoom -= yoffset * 0.5f;
     if (zoom < 1.0f)
         zoom = 1.0f;
     if (zoom > 20.0f)
         zoom = 20.0f;
+    cameraChanged = true;
 }
 
-void setupSphere()
-{
-    glGenVertexArrays(1, &sphereVAO);
-    glBindVertexArray(sphereVAO);
-
-    glGenBuffers(1, &sphereVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-
-    std::vector<GLfloat> sphereVertices;
-    std::vector<GLfloat> sphereColors;
-    std::vector<GLfloat> sphereTexCoords;
-    for (int i = 0; i <= stackCount; ++i)
-    {
-        float stackAngle = glm::pi<float>() / 2 - i * glm::pi<float>() / stackCount;
-        float xy = radius * cosf(stackAngle);
-        float z = radius * sinf(stackAngle);
-        for (int j = 0; j <= sectorCount; ++j)
-        {
-            float sectorAngle = j * 2 * glm::pi<float>() / sectorCount;
-            float x = xy * cosf(sectorAngle);
-            float y = xy * sinf(sectorAngle);
-            sphereVertices.push_back(x);
-            sphereVertices.push_back(y);
-            sphereVertices.push_back(z);
-
-            sphereColors.push_back(1.0f);
-            sphereColors.push_back(1.0f);
-            sphereColors.push_back(1.0f);
-
-            sphereTexCoords.push_back((float)j / sectorCount);
-            sphereTexCoords.push_back((float)i / stackCount);
-        }
-    }
-
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * sphereVertices.size(), sphereVertices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-
-    GLuint colorBuffer;
-    glGenBuffers(1, &colorBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, colorBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * sphereColors.size(), sphereColors.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-
-    GLuint texCoordBuffer;
-    glGenBuffers(1, &texCoordBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, texCoordBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * sphereTexCoords.size(), sphereTexCoords.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
-
-    glBindVertexArray(0);
-}
-
-void setupGround()
-{
-    glGenVertexArrays(1, &groundVAO);
-    glBindVertexArray(groundVAO);
-
-    glGenBuffers(1, &groundVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
-
-    // Dfinir les sommets du sol pour plusieurs parcours
-    std::vector<std::vector<GLfloat>> groundVertices = {
-        // Parcours 1
-        {
-            -5.5f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f,
-            -5.5f, 0.0f, 50.0f, 0.0f, 1.0f, 0.0f,
-            5.5f, 0.0f, 50.0f, 0.0f, 1.0f, 0.0f,
-            5.5f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f,
-            -5.5f, 0.0f, 50.0f, 0.0f, 1.0f, 0.0f,
-            65.5f, 0.0f, 50.0f, 0.0f, 1.0f, 0.0f,
-            65.5f, 0.0f, 65.0f, 0.0f, 1.0f, 0.0f,
-            -5.5f, 0.0f, 65.0f, 0.0f, 1.0f, 0.0f
-        },
-        // Parcours 2
-        {
-            -10.0f, 0.0f, -10.0f, 0.0f, 1.0f, 0.0f,
-            -10.0f, 0.0f, 30.0f, 0.0f, 1.0f, 0.0f,
-            10.0f, 0.0f, 30.0f, 0.0f, 1.0f, 0.0f,
-            10.0f, 0.0f, -10.0f, 0.0f, 1.0f, 0.0f,
-            -10.0f, 0.0f, 30.0f, 0.0f, 1.0f, 0.0f,
-            40.0f, 0.0f, 30.0f, 0.0f, 1.0f, 0.0f,
-            40.0f, 0.0f, 45.0f, 0.0f, 1.0f, 0.0f,
-            -10.0f, 0.0f, 45.0f, 0.0f, 1.0f, 0.0f
-        },
-        // Parcours 3
-        {
-            -3.0f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f,
-            -3.0f, 0.0f, 95.0f, 0.0f, 1.0f, 0.0f,
-            3.0f, 0.0f, 95.0f, 0.0f, 1.0f, 0.0f,
-            3.0f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f
-        }
-    };
-
-    // Configuration initiale du parcours
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * groundVertices[currentCourse].size(), groundVertices[currentCourse].data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-
-    glBindVertexArray(0);
-}
-
-void setupWalls()
-{
-    glGenVertexArrays(1, &wallVAO);
-    glBindVertexArray(wallVAO);
-
-    glGenBuffers(1, &wallVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, wallVBO);
-
-    // Dfinir les sommets des murs pour plusieurs parcours
-    std::vector<std::vector<GLfloat>> wallVertices = {
-        // Parcours 1
-        {
-            -5.5f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 2.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 0.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-
-            5.5f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 2.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 0.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-
-            65.5f, 0.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            65.5f, 2.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 2.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 0.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-
-            65.5f, 0.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-            65.5f, 2.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 2.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 0.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-
-            -5.5f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            5.5f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            -5.5f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-
-            65.5f, 0.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            65.5f, 2.0f, 50.0f, 0.5f, 0.5f, 0.5f,
-            65.5f, 2.0f, 65.0f, 0.5f, 0.5f, 0.5f,
-            65.5f, 0.0f, 65.0f, 0.5f, 0.5f, 0.5f
-        },
-        // Parcours 2
-        {
-            -10.0f, 0.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 2.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 2.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 0.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-
-            10.0f, 0.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 2.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 2.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 0.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-
-            40.0f, 0.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            40.0f, 2.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 2.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 0.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-
-            40.0f, 0.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-            40.0f, 2.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 2.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 0.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-
-            -10.0f, 0.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 0.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            10.0f, 2.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-            -10.0f, 2.0f, -10.0f, 0.5f, 0.5f, 0.5f,
-
-            40.0f, 0.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            40.0f, 2.0f, 30.0f, 0.5f, 0.5f, 0.5f,
-            40.0f, 2.0f, 45.0f, 0.5f, 0.5f, 0.5f,
-            40.0f, 0.0f, 45.0f, 0.5f, 0.5f, 0.5f
-        },
-        // Parcours 3
-        {
-            -3.0f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            -3.0f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            -3.0f, 2.0f, 95.0f, 0.5f, 0.5f, 0.5f,
-            -3.0f, 0.0f, 95.0f, 0.5f, 0.5f, 0.5f,
-
-            3.0f, 0.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            3.0f, 2.0f, -5.0f, 0.5f, 0.5f, 0.5f,
-            3.0f, 2.0f, 95.0f, 0.5f, 0.5f, 0.5f,
-            3.0f, 0.0f, 95.0f, 0.5f, 0.5f, 0.5f
-        }
-    };
-
-    // Configuration initiale du parcours
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * wallVertices[currentCourse].size(), wallVertices[currentCourse].data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-
-    glBindVertexArray(0);
-}
-
-void setupCircle()
+// Met  jour l'affichage quand la simulation a chang de parcours
+void setupCourse(const PhysicsSnapshot& snapshot)
 {
-    glGenVertexArrays(1, &circleVAO);
-    glBindVertexArray(circleVAO);
-
-    glGenBuffers(1, &circleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, circleVBO);
-
-    const int circleSegments = 36;
-    const float circleRadius = 1.2f;
-
-    std::vector<GLfloat> circleVertices;
-
-    // Centre du cercle
-    circleVertices.push_back(0.0f);
-    circleVertices.push_back(0.0f);
-    circleVertices.push_back(0.0f);
-
-    for (int i = 0; i <= circleSegments; ++i)
-    {
-        float angle = i * 2 * glm::pi<float>() / circleSegments;
-        float x = circleRadius * cosf(angle);
-        float z = circleRadius * sinf(angle);
-
-        circleVertices.push_back(x);
-        circleVertices.push_back(0.0f);
-        circleVertices.push_back(z);
-    }
-
-    glBufferData(GL_ARRAY_BUFFER, circleVertices.size() * sizeof(GLfloat), circleVertices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-
-    glBindVertexArray(0);
+    currentCourse = snapshot.course;
+    displayedCourseLoads = snapshot.courseLoads;
+    loadSceneCourse(courses, currentCourse); // Afficher le sol et les murs du parcours, effacer la trane
 }
 
-void setupPowerGauge()
+void loadCourse(int course)
 {
-    glGenVertexArrays(1, &powerGaugeVAO);
-    glBindVertexArray(powerGaugeVAO);
-
-    glGenBuffers(1, &powerGaugeVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, powerGaugeVBO);
-
-    // Dimensions ajustes pour l'indicateur de puissance (repositionn loin du bord droit)
-    GLfloat powerGaugeVertices[] =
-    {
-        // Positions                // Couleurs
-         600.0f, 550.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En bas  gauche
-         600.0f, 580.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En haut  gauche
-         750.0f, 580.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En haut  droite
-         750.0f, 550.0f, 0.0f,      1.0f, 1.0f, 1.0f   // En bas  droite
-    };
-
-    glBufferData(GL_ARRAY_BUFFER, sizeof(powerGaugeVertices), powerGaugeVertices, GL_DYNAMIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-
-    glBindVertexArray(0);
+    currentCourse = course;
+    numShots = 0;
+    showEndText = false;
+    physicsThread.pushInput(PhysicsInput{ PhysicsInputCourse, glm::vec3(0.0f), 0.0f, course }); // Replace la balle au dpart du nouveau parcours
 }
 
-void setupCylinder()
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
-    const int cylinderSegments = 36;
-    const float cylinderRadius = 0.1f;
-    const float cylinderHeight = 7.0f;
-
-    std::vector<GLfloat> cylinderVertices;
-    std::vector<GLuint> cylinderIndices;
-
-    for (int i = 0; i <= cylinderSegments; ++i)
-    {
-        float angle = i * 2 * glm::pi<float>() / cylinderSegments;
-        float x = cylinderRadius * cosf(angle);
-        float z = cylinderRadius * sinf(angle);
-
-        // Base infrieure
-        cylinderVertices.push_back(x);
-        cylinderVertices.push_back(0.0f);
-        cylinderVertices.push_back(z);
-
-        // Base suprieure
-        cylinderVertices.push_back(x);
-        cylinderVertices.push_back(cylinderHeight);
-        cylinderVertices.push_back(z);
-    }
-
-    for (int i = 0; i < cylinderSegments * 2; i += 2)
-    {
-        cylinderIndices.push_back(i);
-        cylinderIndices.push_back(i + 1);
-        cylinderIndices.push_back((i + 2) % (cylinderSegments * 2));
-
-        cylinderIndices.push_back(i + 1);
-        cylinderIndices.push_back((i + 3) % (cylinderSegments * 2));
-        cylinderIndices.push_back((i + 2) % (cylinderSegments * 2));
-    }
-
-    glGenVertexArrays(1, &cylinderVAO);
-    glBindVertexArray(cylinderVAO);
-
-    glGenBuffers(1, &cylinderVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, cylinderVBO);
-    glBufferData(GL_ARRAY_BUFFER, cylinderVertices.size() * sizeof(GLfloat), cylinderVertices.data(), GL_STATIC_DRAW);
-
-    glGenBuffers(1, &cylinderEBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cylinderEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, cylinderIndices.size() * sizeof(GLuint), cylinderIndices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-
-    glBindVertexArray(0);
+    // Date ici, traite par processInput() aprs glfwPollEvents()
+    double time = glfwGetTime();
+    inputQueue.push(InputEvent{ key, action, time });
+    latencyMonitor.onInput(time);
 }
 
-void setupFlag()
+void processInput(const InputEvent& event)
 {
-    glGenVertexArrays(1, &flagVAO);
-    glBindVertexArray(flagVAO);
-
-    glGenBuffers(1, &flagVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, flagVBO);
+    int key = event.key;
+    int action = event.action;
 
-    // Dfinir les sommets du drapeau (triangle rouge plus grand et align  gauche)
-    GLfloat flagVertices[] = {
-        // Positions                // Couleurs
-        0.0f, 7.0f, 0.0f,          1.0f, 0.0f, 0.0f,  // En bas  gauche
-        0.0f, 6.0f, 0.0f,          1.0f, 0.0f, 0.0f,  // En bas  droite
-        1.5f, 6.5f, 0.0f,          1.0f, 0.0f, 0.0f   // En haut
-    };
+    // Pendant une relecture, seules les entres enregistres agissent sur la partie
+    if (player.isLoaded() && key != GLFW_KEY_ESCAPE)
+        return;
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(flagVertices), flagVertices, GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-
-    glBindVertexArray(0);
-}
-
-void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
-{
     if (key == GLFW_KEY_E)
     {
-        double currentTime = glfwGetTime();
         if (action == GLFW_PRESS)
         {
             keyPressDuration = 0.0;
+            shotKeyHeld = true;
+            shotKeyPressTime = event.time;
         }
-        else if (action == GLFW_RELEASE)
+        else if (action == GLFW_RELEASE && shotKeyHeld)
         {
-            if (currentTime - lastShotTime >= shotCooldown)
+            // Dure entre les deux vnements, indpendante du dcoupage en images
+            shotKeyHeld = false;
+            keyPressDuration = std::min(event.time - shotKeyPressTime, maxKeyPressDuration);
+            if (event.time - lastShotTime >= shotCooldown)
             {
                 float impulseStrength = glm::clamp(static_cast<float>(keyPressDuration / maxKeyPressDuration) * maxImpulseStrength, 0.0f, maxImpulseStrength);
 
-                glm::vec3 cameraDirection(
-                    -cos(angleX) * sin(angleY),
-                    0.0f, // 1 pour projeter la balle en l'air, 0 vers le sol
-                    -cos(angleX) * cos(angleY)
-                );
-
-                cameraDirection = glm::normalize(cameraDirection);
+                glm::vec3 cameraDirection = getShotDirection(angleX, angleY);
 
-                sphereVelocity += cameraDirection * impulseStrength;
+                physicsThread.pushInput(PhysicsInput{ PhysicsInputShot, cameraDirection * impulseStrength, static_cast<float>(keyPressDuration), 0 });
                 keyPressDuration = 0.0; // Rinitialiser keyPressDuration lorsque la touche est relche
-                lastShotTime = currentTime; // Mettre  jour le temps du dernier tir
+                lastShotTime = event.time; // Mettre  jour le temps du dernier tir
                 numShots++; // Incrmenter le nombre de tirs
             }
         }
     }
     else if (key == GLFW_KEY_R && action == GLFW_PRESS)
     {
-        spherePosition = initialSpherePosition;
-        sphereVelocity = glm::vec3(0.0f, 0.0f, 0.0f);
+        physicsThread.pushInput(PhysicsInput{ PhysicsInputReset, glm::vec3(0.0f), 0.0f, 0 });
         showEndText = false;
         numShots = 0; // Rinitialiser le nombre de tirs
     }
@@ -487,122 +173,24 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         cursorLocked = !cursorLocked;
         glfwSetInputMode(window, GLFW_CURSOR, cursorLocked ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
     }
+#ifdef GOLF_PROFILE
+    else if (key == GLFW_KEY_F3 && action == GLFW_PRESS) // Affichage du profileur
+    {
+        setProfilerOverlay(!isProfilerOverlayVisible());
+    }
+#endif
     else if (key == GLFW_KEY_KP_1 && action == GLFW_PRESS) // Tlportation au parcours 1
     {
-        currentCourse = 0;
-        initialSpherePosition = glm::vec3(0.0f, radius, 0.0f);
-        spherePosition = initialSpherePosition;
-        trailPositions.clear(); // Effacer la trane
-        setupGround(); // Recharger le sol pour le nouveau parcours
-        setupWalls(); // Recharger les murs pour le nouveau parcours
-        showEndText = false;
+        loadCourse(0);
     }
     else if (key == GLFW_KEY_KP_2 && action == GLFW_PRESS) // Tlportation au parcours 2
     {
-        currentCourse = 1;
-        initialSpherePosition = glm::vec3(-5.0f, radius, -5.0f);
-        spherePosition = initialSpherePosition;
-        trailPositions.clear(); // Effacer la trane
-        setupGround(); // Recharger le sol pour le nouveau parcours
-        setupWalls(); // Recharger les murs pour le nouveau parcours
-        showEndText = false;
+        loadCourse(1);
     }
     else if (key == GLFW_KEY_KP_3 && action == GLFW_PRESS) // Tlportation au parcours 3
     {
-        currentCourse = 2;
-        initialSpherePosition = glm::vec3(0.0f, radius, 0.0f);
-        spherePosition = initialSpherePosition;
-        trailPositions.clear(); // Effacer la trane
-        setupGround(); // Recharger le sol pour le nouveau parcours
-        setupWalls(); // Recharger les murs pour le nouveau parcours
-        showEndText = false;
-    }
-}
-
-GLuint loadShaders(const char* vertex_file_path, const char* fragment_file_path)
-{
-    GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-    GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
-
-    std::string VertexShaderCode;
-    std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
-    if (VertexShaderStream.is_open())
-    {
-        std::stringstream sstr;
-        sstr << VertexShaderStream.rdbuf();
-        VertexShaderCode = sstr.str();
-        VertexShaderStream.close();
-    }
-    else
-    {
-        std::cerr << "Impossible d'ouvrir " << vertex_file_path << ". tes-vous dans le bon rpertoire ?" << std::endl;
-        getchar();
-        return 0;
-    }
-
-    std::string FragmentShaderCode;
-    std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
-    if (FragmentShaderStream.is_open())
-    {
-        std::stringstream sstr;
-        sstr << FragmentShaderStream.rdbuf();
-        FragmentShaderCode = sstr.str();
-        FragmentShaderStream.close();
-    }
-
-    GLint Result = GL_FALSE;
-    int InfoLogLength;
-
-    std::cout << "Compilation du shader: " << vertex_file_path << std::endl;
-    char const* VertexSourcePointer = VertexShaderCode.c_str();
-    glShaderSource(VertexShaderID, 1, &VertexSourcePointer, NULL);
-    glCompileShader(VertexShaderID);
-
-    glGetShaderiv(VertexShaderID, GL_COMPILE_STATUS, &Result);
-    glGetShaderiv(VertexShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-    if (InfoLogLength > 0)
-    {
-        std::vector<char> VertexShaderErrorMessage(InfoLogLength + 1);
-        glGetShaderInfoLog(VertexShaderID, InfoLogLength, NULL, &VertexShaderErrorMessage[0]);
-        std::cerr << &VertexShaderErrorMessage[0] << std::endl;
-    }
-
-    std::cout << "Compilation du shader: " << fragment_file_path << std::endl;
-    char const* FragmentSourcePointer = FragmentShaderCode.c_str();
-    glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer, NULL);
-    glCompileShader(FragmentShaderID);
-
-    glGetShaderiv(FragmentShaderID, GL_COMPILE_STATUS, &Result);
-    glGetShaderiv(FragmentShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-    if (InfoLogLength > 0)
-    {
-        std::vector<char> FragmentShaderErrorMessage(InfoLogLength + 1);
-        glGetShaderInfoLog(FragmentShaderID, InfoLogLength, NULL, &FragmentShaderErrorMessage[0]);
-        std::cerr << &FragmentShaderErrorMessage[0] << std::endl;
-    }
-
-    std::cout << "Lien du programme" << std::endl;
-    GLuint ProgramID = glCreateProgram();
-    glAttachShader(ProgramID, VertexShaderID);
-    glAttachShader(ProgramID, FragmentShaderID);
-    glLinkProgram(ProgramID);
-
-    glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
-    glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-    if (InfoLogLength > 0)
-    {
-        std::vector<char> ProgramErrorMessage(InfoLogLength + 1);
-        glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
-        std::cerr << &ProgramErrorMessage[0] << std::endl;
+        loadCourse(2);
     }
-
-    glDetachShader(ProgramID, VertexShaderID);
-    glDetachShader(ProgramID, FragmentShaderID);
-
-    glDeleteShader(VertexShaderID);
-    glDeleteShader(FragmentShaderID);
-
-    return ProgramID;
 }
 
 bool init()
@@ -622,6 +210,8 @@ bool init()
     }
 
     glfwMakeContextCurrent(window);
+    if (swapIntervalOption >= 0)
+        glfwSwapInterval(swapIntervalOption);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetKeyCallback(window, key_callback);
@@ -639,590 +229,185 @@ bool init()
     glEnable(GL_DEPTH_TEST);
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 
-    setupSphere();
-    setupGround();
-    setupWalls();
-    setupCylinder();
-    setupCircle();
-    setupPowerGauge();
-    setupFlag();
-
-    ballShaderProgram = loadShaders("ball_vertex_shader.glsl", "ball_fragment_shader.glsl");
-    shaderProgram = loadShaders("vertex_shader.glsl", "fragment_shader.glsl");
-    circleShaderProgram = loadShaders("circle_vertex_shader.glsl", "circle_fragment_shader.glsl");
-    poleShaderProgram = loadShaders("pole_vertex_shader.glsl", "pole_fragment_shader.glsl");
-    flagShaderProgram = loadShaders("flag_vertex_shader.glsl", "flag_fragment_shader.glsl");
-    gaugeShaderProgram = loadShaders("gauge_vertex_shader.glsl", "gauge_fragment_shader.glsl");
-    trailShaderProgram = loadShaders("trail_vertex_shader.glsl", "trail_fragment_shader.glsl");
-
-    return true;
-}
-
-void updatePowerGauge(float powerRatio)
-{
-    glBindVertexArray(powerGaugeVAO);
-
-    // Calculer la couleur en fonction du rapport de puissance
-    glm::vec3 color;
-    double currentTime = glfwGetTime();
-    if (currentTime - lastShotTime < shotCooldown)
-    {
-        color = glm::vec3(0.5f, 0.5f, 0.5f); // Couleur grise pendant le temps de rcupration
-    }
-    else
+    if (!courses.load(defaultCourseManifest))
     {
-        if (powerRatio < 0.25f)
-            color = glm::mix(glm::vec3(1.0f), glm::vec3(0.0f, 1.0f, 0.0f), powerRatio * 4.0f);  // Blanc  Vert
-        else if (powerRatio < 0.5f)
-            color = glm::mix(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f), (powerRatio - 0.25f) * 4.0f);  // Vert  Jaune
-        else if (powerRatio < 0.75f)
-            color = glm::mix(glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.5f, 0.0f), (powerRatio - 0.5f) * 4.0f);  // Jaune  Orange
-        else
-            color = glm::mix(glm::vec3(1.0f, 0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), (powerRatio - 0.75f) * 4.0f);  // Orange  Rouge
+        std::cerr << "chec du chargement des parcours" << std::endl;
+        return false;
     }
 
-    GLfloat powerGaugeVertices[] =
-    {
-        // Positions              // Couleurs
-         600.0f, 550.0f, 0.0f,     color.r, color.g, color.b,  // En bas  gauche
-         600.0f, 580.0f, 0.0f,     color.r, color.g, color.b,  // En haut  gauche
-         750.0f, 580.0f, 0.0f,     color.r, color.g, color.b,  // En haut  droite
-         750.0f, 550.0f, 0.0f,     color.r, color.g, color.b   // En bas  droite
-    };
+    if (replayPath && !player.load(replayPath, courses))
+        return false;
 
-    glBindBuffer(GL_ARRAY_BUFFER, powerGaugeVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(powerGaugeVertices), powerGaugeVertices);
+    if (!setupScene())
+        return false;
+    setupCourseGeometry(courses);
+    if (trailLengthOption > 0)
+        setTrailLength(trailLengthOption);
 
-    glBindVertexArray(0);
+    // La simulation charge le parcours de dpart ; la scne suit au premier instantan
+    physicsThread.start(physics, courses, currentCourse, &recorder, player.isLoaded() ? &player : nullptr);
+    return true;
 }
 
 void updateBallRotation(float deltaTime)
 {
-    if (glm::length(sphereVelocity) > 0.0f)
+    // Balle endormie : rien  faire
+    if (physicsThread.getSnapshot().asleep)
+        return;
+
+    const glm::vec3& sphereVelocity = displayedBall.velocity;
+    float speed = glm::length(sphereVelocity);
+    if (speed > 0.0f)
     {
         glm::vec3 rotationAxis = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), sphereVelocity));
-        float rotationAngle = glm::length(sphereVelocity) * deltaTime / radius * rotationSpeedFactor; // Augmenter la vitesse de rotation
+        float rotationAngle = speed * deltaTime / ballRadius * rotationSpeedFactor; // Augmenter la vitesse de rotation
 
         ballRotation = glm::rotate(glm::mat4(1.0f), rotationAngle, rotationAxis) * ballRotation;
     }
 }
 
-void drawPowerGauge()
-{
-    glUseProgram(gaugeShaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::mat4 view = glm::mat4(1.0f);
-    glm::mat4 projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
-
-    GLuint modelLoc = glGetUniformLocation(gaugeShaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(gaugeShaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(gaugeShaderProgram, "projection");
-
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-    glBindVertexArray(powerGaugeVAO);
-    glDrawArrays(GL_QUADS, 0, 4);
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawSphere()
-{
-    glUseProgram(ballShaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, spherePosition) * ballRotation; // Appliquer la rotation
-
-    GLuint modelLoc = glGetUniformLocation(ballShaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(ballShaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(ballShaderProgram, "projection");
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-    glm::vec3 cameraPosition = spherePosition + glm::vec3(
-        zoom * cos(angleX) * sin(angleY),
-        zoom * sin(angleX) - .0f,
-        zoom * cos(angleX) * cos(angleY)
-    );
-    glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(sphereVAO);
-    for (int i = 0; i < stackCount; ++i)
-    {
-        int k1 = i * (sectorCount + 1);
-        int k2 = k1 + sectorCount + 1;
-
-        glBegin(GL_TRIANGLE_STRIP);
-        for (int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
-            glArrayElement(k1);
-            glArrayElement(k2);
-            glArrayElement(k1 + 1);
-
-            glArrayElement(k1 + 1);
-            glArrayElement(k2);
-            glArrayElement(k2 + 1);
-        }
-        glEnd();
-    }
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawGround()
-{
-    glUseProgram(shaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-    glm::vec3 cameraPosition = spherePosition + glm::vec3(
-        zoom * cos(angleX) * sin(angleY),
-        zoom * sin(angleX) + 2.0f,
-        zoom * cos(angleX) * cos(angleY)
-    );
-    glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(groundVAO);
-    glDrawArrays(GL_QUADS, 0, (currentCourse == 2 ? 4 : 8)); // Mettre  jour le nombre de sommets
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawWalls()
-{
-    glUseProgram(shaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-    glm::vec3 cameraPosition = spherePosition + glm::vec3(
-        zoom * cos(angleX) * sin(angleY),
-        zoom * sin(angleX) + 2.0f,
-        zoom * cos(angleX) * cos(angleY)
-    );
-    glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(wallVAO);
-    glDrawArrays(GL_QUADS, 0, (currentCourse == 2 ? 8 : 28)); // Mettre  jour le nombre de sommets
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawCircle()
-{
-    glUseProgram(circleShaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::vec3 holePosition;
-    if (currentCourse == 0)
-        holePosition = glm::vec3(60.0f, 0.02f, 60.0f);
-    else if (currentCourse == 1)
-        holePosition = glm::vec3(35.0f, 0.02f, 37.5f);
-    else
-        holePosition = glm::vec3(0.0f, 0.02f, 90.0f);
-    model = glm::translate(model, holePosition);
-
-    GLuint modelLoc = glGetUniformLocation(circleShaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(circleShaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(circleShaderProgram, "projection");
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-    glm::vec3 cameraPosition = spherePosition + glm::vec3(
-        zoom * cos(angleX) * sin(angleY),
-        zoom * sin(angleX) + 2.0f,
-        zoom * cos(angleX) * cos(angleY)
-    );
-    glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(circleVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 38);
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawCylinder()
-{
-    // Dessiner le cylindre
-    glUseProgram(shaderProgram);
-
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::vec3 cylinderPosition;
-    if (currentCourse == 0)
-        cylinderPosition = glm::vec3(60.0f, 0.0f, 60.0f);
-    else if (currentCourse == 1)
-        cylinderPosition = glm::vec3(35.0f, 0.0f, 37.5f);
-    else
-        cylinderPosition = glm::vec3(0.0f, 0.0f, 90.0f);
-    model = glm::translate(model, cylinderPosition);
-
-    GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-    glm::vec3 cameraPosition = spherePosition + glm::vec3(
-        zoom * cos(angleX) * sin(angleY),
-        zoom * sin(angleX) + 2.0f,
-        zoom * cos(angleX) * cos(angleY)
-    );
-    glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(cylinderVAO);
-    glDrawElements(GL_TRIANGLES, 36 * 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-
-    // Dessiner le drapeau
-    glUseProgram(flagShaderProgram); // Utiliser le nouveau programme de shader pour le drapeau
-
-    model = glm::mat4(1.0f);
-    model = glm::translate(model, cylinderPosition);
-
-    modelLoc = glGetUniformLocation(flagShaderProgram, "model");
-    viewLoc = glGetUniformLocation(flagShaderProgram, "view");
-    projLoc = glGetUniformLocation(flagShaderProgram, "projection");
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-    glBindVertexArray(flagVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    glBindVertexArray(0);
-
-    glUseProgram(0);
-}
-
-void drawTrail()
-{
-    glUseProgram(trailShaderProgram);
-
-    for (size_t i = 0; i < trailPositions.size(); ++i)
-    {
-        glm::vec3 position = trailPositions[i];
-        float scale = 0.5f * (float)i / maxTrailLength; // Sphres plus grandes pour les nouvelles positions, plus petites pour les anciennes
-        glm::vec4 color = glm::vec4(0.0f, 1.0f, 1.0f, 1.0f - (float)i / maxTrailLength); // Couleur cyan avec effet de dgrad
-
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = glm::scale(model, glm::vec3(scale));
-
-        GLuint modelLoc = glGetUniformLocation(trailShaderProgram, "model");
-        GLuint viewLoc = glGetUniformLocation(trailShaderProgram, "view");
-        GLuint projLoc = glGetUniformLocation(trailShaderProgram, "projection");
-        GLuint colorLoc = glGetUniformLocation(trailShaderProgram, "color");
-
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-
-        glm::vec3 cameraPosition = spherePosition + glm::vec3(
-            zoom * cos(angleX) * sin(angleY),
-            zoom * sin(angleX) + 2.0f,
-            zoom * cos(angleX) * cos(angleY)
-        );
-        glm::mat4 view = glm::lookAt(cameraPosition, spherePosition, glm::vec3(0.0f, 1.0f, 0.0f));
-
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform4fv(colorLoc, 1, glm::value_ptr(color));
-
-        glBindVertexArray(sphereVAO);
-        for (int j = 0; j < stackCount; ++j)
-        {
-            int k1 = j * (sectorCount + 1);
-            int k2 = k1 + sectorCount + 1;
-
-            glBegin(GL_TRIANGLE_STRIP);
-            for (int l = 0; l < sectorCount; ++l, ++k1, ++k2)
-            {
-                glArrayElement(k1);
-                glArrayElement(k2);
-                glArrayElement(k1 + 1);
-
-                glArrayElement(k1 + 1);
-                glArrayElement(k2);
-                glArrayElement(k2 + 1);
-            }
-            glEnd();
-        }
-        glBindVertexArray(0);
-    }
-
-    glUseProgram(0);
-}
-
-void checkSphereBounds() {
-    // Dfinir les limites pour chaque parcours
-    std::vector<std::vector<float>> boundaries = {
-        // Parcours 1
-        { -5.5f, 5.5f, 65.5f, -5.0f, 50.0f, 65.0f },
-        // Parcours 2
-        { -10.0f, 10.0f, 40.0f, -10.0f, 30.0f, 45.0f },
-        // Parcours 3
-        { -3.0f, 3.0f, -5.0f, 95.0f }  // { minX, maxX, minZ, maxZ }
-    };
-
-    auto& bounds = boundaries[currentCourse];
-
-    if (currentCourse != 2) {
-        // Vrifier les collisions avec les murs latraux de la section principale
-        if (spherePosition.x <= bounds[0] + radius && (spherePosition.z >= bounds[3] + radius && spherePosition.z <= bounds[4] - radius)) {
-            spherePosition.x = bounds[0] + radius; // Repositionner la sphre
-            sphereVelocity.x *= -dampingFactor;
-            if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                sphereVelocity.x = 0.0f;
-            }
-        }
-        else if (spherePosition.x >= bounds[1] - radius && (spherePosition.z >= bounds[3] + radius && spherePosition.z <= bounds[4] - radius)) {
-            spherePosition.x = bounds[1] - radius; // Repositionner la sphre
-            sphereVelocity.x *= -dampingFactor;
-            if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                sphereVelocity.x = 0.0f;
-            }
-        }
-
-        // Vrifier les collisions avec les murs de la section ajoute pour former la forme en L (Parcours 1 et Parcours 2 seulement)
-        if (currentCourse != 2) {
-            if (spherePosition.x >= bounds[2] - radius && (spherePosition.z >= bounds[4] + radius && spherePosition.z <= bounds[5] - radius)) {
-                spherePosition.x = bounds[2] - radius; // Repositionner la sphre
-                sphereVelocity.x *= -dampingFactor;
-                if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                    sphereVelocity.x = 0.0f;
-                }
-            }
-
-            if (spherePosition.z >= bounds[5] - radius && (spherePosition.x >= bounds[0] + radius && spherePosition.x <= bounds[2] - radius)) {
-                spherePosition.z = bounds[5] - radius; // Repositionner la sphre
-                sphereVelocity.z *= -dampingFactor;
-                if (std::abs(sphereVelocity.z) < minBounceSpeed) {
-                    sphereVelocity.z = 0.0f;
-                }
-            }
-
-            // Vrifier les collisions avec les murs latraux de la section ajoute (partie horizontale)
-            if (spherePosition.z >= bounds[4] && (spherePosition.x <= bounds[0] + radius)) {
-                spherePosition.x = bounds[0] + radius; // Repositionner la sphre
-                sphereVelocity.x *= -dampingFactor;
-                if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                    sphereVelocity.x = 0.0f;
-                }
-            }
-            else if (spherePosition.z >= bounds[4] && (spherePosition.x >= bounds[2] - radius)) {
-                spherePosition.x = bounds[2] - radius; // Repositionner la sphre
-                sphereVelocity.x *= -dampingFactor;
-                if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                    sphereVelocity.x = 0.0f;
-                }
-            }
-        }
-
-        // Vrifier les collisions avec les murs au dbut de la section principale
-        if (spherePosition.z <= bounds[3] + radius) {
-            spherePosition.z = bounds[3] + radius; // Repositionner la sphre
-            sphereVelocity.z *= -dampingFactor;
-            if (std::abs(sphereVelocity.z) < minBounceSpeed) {
-                sphereVelocity.z = 0.0f;
-            }
-        }
-    }
-    else {
-        // Vrifications spcifiques pour les limites du parcours 3
-        if (spherePosition.x <= bounds[0] + radius) {
-            spherePosition.x = bounds[0] + radius; // Repositionner la sphre
-            sphereVelocity.x *= -dampingFactor;
-            if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                sphereVelocity.x = 0.0f;
-            }
-        }
-        else if (spherePosition.x >= bounds[1] - radius) {
-            spherePosition.x = bounds[1] - radius; // Repositionner la sphre
-            sphereVelocity.x *= -dampingFactor;
-            if (std::abs(sphereVelocity.x) < minBounceSpeed) {
-                sphereVelocity.x = 0.0f;
-            }
-        }
-
-        if (spherePosition.z <= bounds[2] + radius) {
-            spherePosition.z = bounds[2] + radius; // Repositionner la sphre
-            sphereVelocity.z *= -dampingFactor;
-            if (std::abs(sphereVelocity.z) < minBounceSpeed) {
-                sphereVelocity.z = 0.0f;
-            }
-        }
-        else if (spherePosition.z >= bounds[3] - radius) {
-            spherePosition.z = bounds[3] - radius; // Repositionner la sphre
-            sphereVelocity.z *= -dampingFactor;
-            if (std::abs(sphereVelocity.z) < minBounceSpeed) {
-                sphereVelocity.z = 0.0f;
-            }
-        }
-    }
-
-    // Vrifier les collisions avec le sol
-    if (spherePosition.y <= radius) {
-        spherePosition.y = radius;
-        sphereVelocity.y *= -dampingFactor;
-        if (std::abs(sphereVelocity.y) < minBounceSpeed) {
-            sphereVelocity.y = 0.0f;
-        }
-    }
-}
-
-
-
 bool checkHoleCollision()
 {
-    float holeRadius = 1.5f;
-    glm::vec3 holePosition;
-    if (currentCourse == 0)
-        holePosition = glm::vec3(60.0f, 0.0f, 60.0f);
-    else if (currentCourse == 1)
-        holePosition = glm::vec3(35.0f, 0.0f, 37.5f);
-    else
-        holePosition = glm::vec3(0.0f, 0.0f, 90.0f);
-
-    float distance = glm::distance(spherePosition, holePosition);
-    if (distance < holeRadius)
+    // Tant que la simulation n'a pas reu toutes nos entres, l'instantan prcde le dernier changement de parcours
+    const PhysicsSnapshot& snapshot = physicsThread.getSnapshot();
+    bool upToDate = snapshot.inputCount == physicsThread.getPushedInputCount();
+    if (snapshot.inHole && upToDate && !levelTransition)
     {
         std::cout << "Parcours termin !" << std::endl;
         lastShotTime = glfwGetTime() - shotCooldown; // Rinitialiser le temps de rcupration du tir
         levelTransition = true;
         endTime = glfwGetTime();
+        holeShots = numShots;
         return true;
     }
     return false;
 }
 
-void draw()
+SceneView getSceneView()
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    SceneView scene;
+    glfwGetFramebufferSize(window, &scene.width, &scene.height);
+    scene.angleX = angleX;
+    scene.angleY = angleY;
+    scene.zoom = zoom;
+    scene.ballPosition = displayedBall.position;
+    scene.ballRotation = ballRotation;
+    return scene;
+}
 
-    // Mettre  jour les positions de la trane
-    if (trailPositions.size() >= maxTrailLength)
+// Textes du HUD de l'image, tous dessins par drawScene() en une seule commande
+void updateHud()
+{
+    // Images par seconde, moyennes sur une demi-seconde
+    ++fpsFrames;
+    double now = glfwGetTime();
+    if (now - fpsTime >= 0.5)
     {
-        trailPositions.erase(trailPositions.begin()); // Supprimer la position la plus ancienne si nous dpassons la longueur maximale de la trane
+        framesPerSecond = fpsFrames / (now - fpsTime);
+        fpsTime = now;
+        fpsFrames = 0;
     }
-    trailPositions.push_back(spherePosition); // Ajouter la position actuelle  la trane
 
-    drawGround();
-    drawWalls();
-    drawTrail(); // Dessiner la trane avant de dessiner la sphre
-    drawCircle();
-    drawCylinder();
+    glm::vec3 white = glm::vec3(1.0f);
+    addHudText("Parcours " + std::to_string(currentCourse + 1) + "/" + std::to_string(courses.getCourseCount()), 10.0f, 35.0f, 0.5f, white);
+    addHudText("Coups : " + std::to_string(numShots), 10.0f, 12.0f, 0.5f, white);
+    addHudText(std::to_string((int)(framesPerSecond + 0.5)) + " FPS", 600.0f, 530.0f, 0.4f, white);
 
-    for (int i = 0; i < subSteps; ++i)
+    if (showEndText)
     {
-        spherePosition.y += sphereVelocity.y / subSteps;
-        spherePosition.x += sphereVelocity.x / subSteps;
-        spherePosition.z += sphereVelocity.z / subSteps;
-
-        sphereVelocity *= pow(friction, 1.0f / subSteps); // Appliquer la friction par sous-tape
-
-        sphereVelocity.y -= gravity / subSteps;
-
-        // Vrifier si la sphre est au-dessus du sol
-        if (spherePosition.y <= radius)
-        {
-            spherePosition.y = radius;
-            sphereVelocity.y *= -dampingFactor;
-            if (std::abs(sphereVelocity.y) < minBounceSpeed)
-            {
-                sphereVelocity.y = 0.0f;
-            }
-        }
-
-        // Vrifier les collisions avec les murs
-        checkSphereBounds();
+        std::string message = "Parcours termin en " + std::to_string(holeShots) + (holeShots > 1 ? " coups !" : " coup !");
+        addHudText(message, 400.0f - getHudTextWidth(message, 0.8f) / 2.0f, 300.0f, 0.8f, glm::vec3(1.0f, 0.85f, 0.2f));
     }
+}
 
+void draw()
+{
     // Vrifier si la sphre est entre dans le trou
-    if (checkHoleCollision())
-    {
-        sphereVelocity = glm::vec3(0.0f, 0.0f, 0.0f);
-    }
+    checkHoleCollision();
 
-    drawSphere();
-    drawPowerGauge();
+    pushTrailPosition(displayedBall.position); // Mettre  jour les positions de la trane
+    updateHud();
+    drawScene(getSceneView());
 
     if (levelTransition && glfwGetTime() - endTime > levelTransitionDelay)
     {
         // Attendre le dlai de transition
         levelTransition = false;
-        currentCourse = (currentCourse + 1) % 3; // Passer au parcours suivant (y compris le troisime parcours)
-        initialSpherePosition = currentCourse == 0 ? glm::vec3(0.0f, radius, 0.0f) : (currentCourse == 1 ? glm::vec3(-5.0f, radius, -5.0f) : glm::vec3(0.0f, radius, 0.0f));
-        spherePosition = initialSpherePosition;
-        trailPositions.clear(); // Effacer la trane
-        setupGround(); // Recharger le sol pour le nouveau parcours
-        setupWalls(); // Recharger les murs pour le nouveau parcours
-        showEndText = false;
+        if (!player.isLoaded()) // En relecture, le changement de parcours vient de l'enregistrement
+            loadCourse((currentCourse + 1) % courses.getCourseCount()); // Passer au parcours suivant (y compris le troisime parcours)
+        showEndText = true; // Message de fin affich sur le parcours suivant
     }
 
     if (showEndText && glfwGetTime() - endTime > 3.0)
     {
         // Attendre 3 secondes
-        spherePosition = initialSpherePosition;
-        sphereVelocity = glm::vec3(0.0f, 0.0f, 0.0f);
         showEndText = false;
     }
 
-    glfwSwapBuffers(window);
+    {
+        PROFILE_CPU("glfwSwapBuffers");
+        glfwSwapBuffers(window);
+    }
+
+    // glFinish() : l'image est rellement affiche (ou prte  l'tre) et pas seulement mise en file.
+    // Fausse un peu le rythme, donc seulement pendant les mesures
+    if (latencyMonitor.isEnabled())
+    {
+        glFinish();
+        latencyMonitor.onPresent(glfwGetTime());
+    }
 }
 
-int main()
+
+int main(int argc, char** argv)
 {
+    // --record <fichier> enregistre les entres de la partie, --replay <fichier> les rejoue  vitesse normale,
+    // --trail <n> fixe la longueur de la trane, --swap-interval <n> l'intervalle de synchronisation,
+    // --latency <fichier> mesure la latence entre-prsentation de chaque image, --profile-trace <fichier> et --profile-csv <fichier>
+    // enregistrent les mesures du profileur
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (option == "--record")
+        {
+            recorder.start(argv[i + 1]);
+        }
+        else if (option == "--replay")
+        {
+            replayPath = argv[i + 1];
+        }
+        else if (option == "--trail")
+        {
+            trailLengthOption = std::atoi(argv[i + 1]);
+        }
+        else if (option == "--swap-interval")
+        {
+            swapIntervalOption = std::atoi(argv[i + 1]);
+        }
+        else if (option == "--latency")
+        {
+            latencyCsvPath = argv[i + 1];
+            latencyMonitor.setEnabled(true);
+        }
+#ifdef GOLF_PROFILE
+        else if (option == "--profile-trace")
+        {
+            profileTracePath = argv[i + 1];
+        }
+        else if (option == "--profile-csv")
+        {
+            profileCsvPath = argv[i + 1];
+        }
+#endif
+    }
+
     if (!init())
         return -1;
+    std::cout << "Dmarrage en " << glfwGetTime() * 1000.0 << " ms" << std::endl; // Depuis glfwInit(), shaders compris
+#ifdef GOLF_PROFILE
+    if (profileTracePath || profileCsvPath)
+        profiler.setRecording(true);
+#endif
 
     while (!glfwWindowShouldClose(window))
     {
@@ -1230,20 +415,77 @@ int main()
         double deltaTime = currentTime - lastTime;
         lastTime = currentTime;
 
-        glfwPollEvents();
-
-        if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
         {
-            keyPressDuration += deltaTime;
-            keyPressDuration = std::min(keyPressDuration, maxKeyPressDuration);
+            PROFILE_CPU("glfwPollEvents");
+            glfwPollEvents();
         }
 
-        updatePowerGauge(static_cast<float>(keyPressDuration / maxKeyPressDuration));
+        InputEvent event;
+        while (inputQueue.pop(event))
+            processInput(event);
+
+        // Au plus un vnement camra par image, dat par la simulation comme les tirs
+        if (cameraChanged && recorder.isRecording())
+            physicsThread.pushInput(PhysicsInput{ PhysicsInputCamera, glm::vec3(angleX, angleY, zoom), 0.0f, 0 });
+        cameraChanged = false;
+
+        if (shotKeyHeld)
+            keyPressDuration = glm::clamp(currentTime - shotKeyPressTime, 0.0, maxKeyPressDuration);
+
+        updatePowerGauge(static_cast<float>(keyPressDuration / maxKeyPressDuration), currentTime - lastShotTime < shotCooldown);
+
+        // La simulation avance seule  pas fixe ; l'image montre l'tat d'il y a un pas, interpol,
+        // pour toujours tomber entre deux instantans quel que soit le rythme du rendu
+        physicsThread.updateSnapshot();
+        const PhysicsSnapshot& snapshot = physicsThread.getSnapshot();
+        if (snapshot.courseLoads != displayedCourseLoads)
+            setupCourse(snapshot);
+        if (snapshot.camera.valid) // Relecture : la vue du joueur remplace la souris
+        {
+            angleX = snapshot.camera.angleX;
+            angleY = snapshot.camera.angleY;
+            zoom = snapshot.camera.zoom;
+        }
+        displayedBall = interpolateBall(physicsThread.getPreviousSnapshot(), snapshot, physicsThread.getTime() - fixedTimeStep);
         updateBallRotation(deltaTime);
 
         draw();
+
+        PROFILE_GPU_COLLECT();
+        PROFILE_END_FRAME();
     }
 
+    physicsThread.stop(); // physics, recorder et player reviennent au thread principal
+    currentCourse = physicsThread.getCourse();
+    std::cout << physics.getSkippedSteps() << " pas de physique vits pendant le sommeil de la balle" << std::endl;
+
+    if (recorder.isRecording() && recorder.save(physics, currentCourse))
+        std::cout << "Enregistrement sauvegard (" << physics.getStepCount() << " pas)" << std::endl;
+
+    if (player.isLoaded() && player.isFinished(physics) && player.verify(physics, currentCourse))
+        std::cout << "Relecture termine, tat final identique  l'enregistrement" << std::endl;
+
+    if (latencyCsvPath)
+    {
+        std::cout << latencyMonitor.getInputLatency().getReport("Latence entre-prsentation")
+                  << latencyMonitor.getFrameInterval().getReport("Intervalle entre prsentations");
+        if (latencyMonitor.writeCsv(latencyCsvPath))
+            std::cout << "Mesures de latence crites dans " << latencyCsvPath << std::endl;
+    }
+
+#ifdef GOLF_PROFILE
+    if (profileTracePath && profiler.writeChromeTrace(profileTracePath))
+        std::cout << "Trace du profileur crite dans " << profileTracePath << std::endl;
+    if (profileCsvPath && profiler.writeCsv(profileCsvPath))
+        std::cout << "Mesures du profileur crites dans " << profileCsvPath << std::endl;
+    gpuProfiler.release();
+#endif
+
+    // Tout objet encore vivant aprs releaseScene() n'a pas de propritaire : c'est une fuite
+    releaseScene();
+    if (glResources.getTotalCount() > 0)
+        std::cerr << "Objets OpenGL non librs :\n" << glResources.getReport();
+
     glfwTerminate();
     return 0;
 }
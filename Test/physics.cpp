@@ -0,0 +1,520 @@
+#include "physics.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+const float subStepFriction = std::pow(friction, 1.0f / subSteps);
+
+glm::vec3 getShotDirection(float angleX, float angleY)
+{
+    glm::vec3 cameraDirection(
+        -cos(angleX) * sin(angleY),
+        0.0f, // 1 pour projeter la balle en l'air, 0 vers le sol
+        -cos(angleX) * cos(angleY)
+    );
+
+    return glm::normalize(cameraDirection);
+}
+
+ShotResult simulateShot(const CourseLibrary& courses, int index, const glm::vec3& impulse, int maxSteps, CollisionMode mode)
+{
+    Physics physics;
+    physics.setCourse(courses, index);
+    physics.setCollisionMode(mode);
+    physics.applyImpulse(impulse);
+
+    int steps = 0;
+    while (steps < maxSteps)
+    {
+        physics.fixedStep();
+        steps++;
+
+        if (physics.isInHole() || physics.isAtRest())
+            break;
+    }
+
+    ShotResult result;
+    result.finalPosition = physics.getBall().position;
+    result.inHole = physics.isInHole();
+    result.wallContacts = physics.getWallContacts();
+    result.steps = steps;
+    return result;
+}
+
+ShotResult predictShot(const CourseLibrary& courses, int index, const glm::vec3& impulse)
+{
+    Physics physics;
+    physics.setCourse(courses, index);
+    physics.applyImpulse(impulse);
+    return physics.predictRest();
+}
+
+Physics::Physics()
+{
+    course = nullptr;
+    accumulator = 0.0;
+    inHole = false;
+    wallContacts = 0;
+    collisionMode = ContinuousCollision;
+    asleep = false;
+    restSteps = 0;
+    skippedSteps = 0;
+    stepCount = 0;
+    ball.position = glm::vec3(0.0f, ballRadius, 0.0f);
+    ball.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+}
+
+void Physics::setCourse(const CourseLibrary& courses, int index)
+{
+    course = &courses.getCourse(index);
+    walls = courses.getWalls(index);
+    reset();
+}
+
+void Physics::reset()
+{
+    reset(course->startPosition);
+}
+
+void Physics::reset(const glm::vec3& position)
+{
+    ball.position = position;
+    ball.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+    accumulator = 0.0;
+    inHole = false;
+    wallContacts = 0;
+    asleep = false;
+    restSteps = 0;
+}
+
+void Physics::applyImpulse(const glm::vec3& impulse)
+{
+    ball.velocity += impulse;
+    asleep = false;
+    restSteps = 0;
+}
+
+void Physics::setCollisionMode(CollisionMode mode)
+{
+    collisionMode = mode;
+}
+
+int Physics::step(double deltaTime)
+{
+    PROFILE_CPU("physics");
+    accumulator += deltaTime;
+
+    int steps = 0;
+    while (accumulator >= fixedTimeStep && steps < maxStepsPerUpdate)
+    {
+        fixedStep();
+        accumulator -= fixedTimeStep;
+        steps++;
+    }
+
+    // Si la frame a t trop longue, on abandonne le retard plutt que de rattraper indfiniment
+    if (steps == maxStepsPerUpdate && accumulator >= fixedTimeStep)
+    {
+        accumulator = 0.0;
+    }
+
+    return steps;
+}
+
+void Physics::fixedStep()
+{
+    stepCount++;
+
+    // Une balle endormie ne cote plus rien jusqu'au prochain tir
+    if (asleep)
+    {
+        skippedSteps++;
+        return;
+    }
+
+    if (collisionMode == ContinuousCollision)
+        continuousStep();
+    else
+        discreteStep();
+
+    if (isAtRest())
+    {
+        restSteps++;
+        if (restSteps >= sleepSteps)
+        {
+            ball.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+            asleep = true;
+        }
+    }
+    else
+    {
+        restSteps = 0;
+    }
+}
+
+void Physics::discreteStep()
+{
+    for (int i = 0; i < subSteps; ++i)
+    {
+        ball.position.y += ball.velocity.y / subSteps;
+        ball.position.x += ball.velocity.x / subSteps;
+        ball.position.z += ball.velocity.z / subSteps;
+
+        ball.velocity *= subStepFriction; // Appliquer la friction par sous-tape
+
+        ball.velocity.y -= gravity / subSteps;
+
+        // Vrifier si la sphre est au-dessus du sol
+        if (ball.position.y <= ballRadius)
+        {
+            ball.position.y = ballRadius;
+            ball.velocity.y *= -dampingFactor;
+            if (std::abs(ball.velocity.y) < minBounceSpeed)
+            {
+                ball.velocity.y = 0.0f;
+            }
+        }
+
+        // Vrifier les collisions avec les murs
+        checkSphereBounds(walls, ball.position, ball.velocity, wallContacts);
+    }
+
+    // Vrifier si la sphre est entre dans le trou
+    if (checkHoleCollision())
+    {
+        ball.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+        inHole = true;
+    }
+}
+
+// Rflexion amortie de la vitesse sur un mur de normale donne (plan xz)
+static void bounceOnWall(glm::vec3& velocity, const glm::vec2& normal)
+{
+    glm::vec2 planarVelocity(velocity.x, velocity.z);
+    float normalSpeed = glm::dot(planarVelocity, normal);
+    float bounceSpeed = -normalSpeed * dampingFactor;
+    if (bounceSpeed < minBounceSpeed)
+        bounceSpeed = 0.0f;
+
+    planarVelocity += normal * (bounceSpeed - normalSpeed);
+    velocity.x = planarVelocity.x;
+    velocity.z = planarVelocity.y;
+}
+
+// Premier instant t de [0, 1] o le segment from -> to entre dans la sphre (center, radius)
+static bool sweepSphere(const glm::vec3& from, const glm::vec3& to, const glm::vec3& center, float radius, float& time)
+{
+    glm::vec3 delta = to - from;
+    glm::vec3 offset = from - center;
+    float c = glm::dot(offset, offset) - radius * radius;
+    if (c <= 0.0f)
+    {
+        time = 0.0f;
+        return true;
+    }
+
+    float a = glm::dot(delta, delta);
+    float b = glm::dot(offset, delta);
+    float discriminant = b * b - a * c;
+    if (b >= 0.0f || discriminant < 0.0f)
+        return false;
+
+    time = (-b - std::sqrt(discriminant)) / a;
+    return time <= 1.0f;
+}
+
+void Physics::continuousStep()
+{
+    float remaining = 1.0f; // Fraction du pas restant  simuler
+    glm::vec2 resolvedNormal(0.0f); // Normale du dernier impact contre un mur pendant ce pas
+
+    for (int contact = 0; contact < maxContactsPerStep && remaining > 0.0f; ++contact)
+    {
+        if (ball.position.y < ballRadius)
+            ball.position.y = ballRadius;
+        if (ball.position.y <= ballRadius && ball.velocity.y < 0.0f)
+            bounceOnGround();
+
+        // Pose au sol, la balle ne tombe plus : la raction du sol compense la gravit
+        float fall = ball.position.y <= ballRadius && ball.velocity.y == 0.0f ? 0.0f : gravity;
+
+        // Prochain impact avec le sol (trajectoire parabolique)
+        float time = remaining;
+        bool groundHit = false;
+        if (fall > 0.0f)
+        {
+            float height = ball.position.y - ballRadius;
+            float groundTime = (ball.velocity.y + std::sqrt(ball.velocity.y * ball.velocity.y + 2.0f * fall * height)) / fall;
+            if (groundTime <= time)
+            {
+                time = groundTime;
+                groundHit = true;
+            }
+        }
+
+        // Prochain impact avec un mur (trajectoire rectiligne dans le plan xz)
+        glm::vec2 wallNormal;
+        float wallTime;
+        bool wallHit = sweepWalls(walls, glm::vec2(ball.position.x, ball.position.z), glm::vec2(ball.velocity.x, ball.velocity.z), time, resolvedNormal, wallTime, wallNormal);
+        if (wallHit)
+        {
+            time = wallTime;
+            groundHit = false;
+        }
+
+        glm::vec3 from = ball.position;
+        ball.position.x += ball.velocity.x * time;
+        ball.position.z += ball.velocity.z * time;
+        ball.position.y += (ball.velocity.y - 0.5f * fall * time) * time;
+        ball.velocity.y -= fall * time;
+
+        // Le trou est test sur tout le trajet : une balle rapide ne peut plus passer par-dessus
+        float holeTime;
+        if (sweepSphere(from, ball.position, course->holePosition, holeRadius, holeTime))
+        {
+            ball.position = from + (ball.position - from) * holeTime;
+            ball.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+            inHole = true;
+            return;
+        }
+
+        if (wallHit)
+        {
+            bounceOnWall(ball.velocity, wallNormal);
+            wallContacts++;
+            resolvedNormal = wallNormal;
+        }
+        else if (groundHit)
+        {
+            ball.position.y = ballRadius;
+            bounceOnGround();
+        }
+
+        remaining -= time;
+    }
+
+    ball.velocity *= friction;
+}
+
+// Nombre de fins de pas avant que la vitesse (multiplie par friction  chaque fin de pas) passe sous restSpeed
+static int stepsToRest(double speed)
+{
+    if (speed < restSpeed)
+        return 1;
+    return std::max(1, (int)std::floor(std::log(restSpeed / speed) / std::log((double)friction)) + 1);
+}
+
+// Distance parcourue pendant les count prochaines fins de pas, en partant de phase dans le pas en cours
+static double rollingDistance(double speed, double phase, int count)
+{
+    return speed * (1.0 - phase) + speed * friction * (1.0 - std::pow((double)friction, count - 1)) / (1.0 - friction);
+}
+
+// Fait rouler la balle de distance : la vitesse est constante pendant un pas et multiplie par friction  la fin
+static void advanceRolling(double distance, double& speed, double& phase, int& steps)
+{
+    double left = speed * (1.0 - phase);
+    if (distance < left)
+    {
+        phase += distance / speed;
+        return;
+    }
+
+    distance -= left;
+    speed *= friction;
+    phase = 0.0;
+    steps++;
+
+    // Pas complets : speed * (1 - friction^count) / (1 - friction) <= distance
+    double ratio = 1.0 - distance * (1.0 - friction) / speed;
+    int count = ratio > 0.0 ? std::max(0, (int)std::floor(std::log(ratio) / std::log((double)friction))) : 0;
+    distance -= speed * (1.0 - std::pow((double)friction, count)) / (1.0 - friction);
+    speed *= std::pow((double)friction, count);
+    steps += count;
+    phase = std::min(std::max(distance / speed, 0.0), 1.0);
+}
+
+ShotResult Physics::predictRest() const
+{
+    Physics copy(*this);
+
+    // Phase balistique : simulation pas  pas jusqu' ce que la balle roule au sol
+    int steps = 0;
+    while (!copy.inHole && !copy.isAtRest() && steps < maxPredictionSteps
+        && !(copy.ball.position.y <= ballRadius && copy.ball.velocity.y == 0.0f))
+    {
+        copy.fixedStep();
+        steps++;
+    }
+
+    ShotResult result;
+    result.inHole = copy.inHole;
+    result.wallContacts = copy.wallContacts;
+    result.finalPosition = copy.ball.position;
+    result.steps = steps;
+    if (copy.inHole || copy.isAtRest() || steps >= maxPredictionSteps)
+        return result;
+
+    // Phase de roulement : d'impact en impact
+    glm::vec3 position = copy.ball.position;
+    glm::vec3 velocity = copy.ball.velocity;
+    double phase = 0.0; // Fraction dj coule du pas en cours
+    glm::vec2 resolvedNormal(0.0f); // Normale du dernier impact, comme pour continuousStep
+
+    for (int contact = 0; contact < maxPredictionContacts; ++contact)
+    {
+        double speed = glm::length(velocity);
+        glm::vec2 direction = glm::vec2(velocity.x, velocity.z) / (float)speed;
+
+        int count = stepsToRest(speed);
+        float distance = (float)rollingDistance(speed, phase, count);
+
+        float wallDistance;
+        glm::vec2 wallNormal;
+        bool wallHit = sweepWalls(walls, glm::vec2(position.x, position.z), direction, distance, resolvedNormal, wallDistance, wallNormal);
+        if (wallHit)
+            distance = wallDistance;
+
+        glm::vec3 from = position;
+        glm::vec3 to = position + glm::vec3(direction.x, 0.0f, direction.y) * distance;
+
+        float holeTime;
+        if (sweepSphere(from, to, course->holePosition, holeRadius, holeTime))
+        {
+            advanceRolling(distance * holeTime, speed, phase, steps);
+            result.finalPosition = from + (to - from) * holeTime;
+            result.inHole = true;
+            result.steps = steps + 1;
+            return result;
+        }
+
+        position = to;
+        if (!wallHit)
+        {
+            result.finalPosition = position;
+            result.steps = steps + count;
+            return result;
+        }
+
+        advanceRolling(distance, speed, phase, steps);
+        velocity = glm::vec3(direction.x, 0.0f, direction.y) * (float)speed;
+        bounceOnWall(velocity, wallNormal);
+        result.wallContacts++;
+        resolvedNormal = wallNormal;
+
+        // La rflexion peut annuler toute la vitesse (impact de face trop lent)
+        if (glm::length(velocity) < restSpeed)
+        {
+            result.finalPosition = position;
+            result.steps = steps + 1;
+            return result;
+        }
+    }
+
+    // Trop d'impacts (balle coince dans un coin) : la prdiction n'est plus fiable,
+    // la fin du tir est simule pas  pas depuis le dbut du roulement
+    steps = result.steps;
+    while (!copy.inHole && !copy.isAtRest() && steps < maxPredictionSteps)
+    {
+        copy.fixedStep();
+        steps++;
+    }
+
+    result.inHole = copy.inHole;
+    result.wallContacts = copy.wallContacts;
+    result.finalPosition = copy.ball.position;
+    result.steps = steps;
+    return result;
+}
+
+glm::vec3 Physics::predictRestPosition() const
+{
+    return predictRest().finalPosition;
+}
+
+double Physics::timeToRest() const
+{
+    return predictRest().steps * fixedTimeStep;
+}
+
+void Physics::bounceOnGround()
+{
+    ball.velocity.y *= -dampingFactor;
+    if (std::abs(ball.velocity.y) < minBounceSpeed)
+    {
+        ball.velocity.y = 0.0f;
+    }
+}
+
+const BallState& Physics::getBall() const
+{
+    return ball;
+}
+
+const Course& Physics::getCourse() const
+{
+    return *course;
+}
+
+bool Physics::isInHole() const
+{
+    return inHole;
+}
+
+bool Physics::isAtRest() const
+{
+    return ball.position.y <= ballRadius && glm::length(ball.velocity) < restSpeed;
+}
+
+bool Physics::isAsleep() const
+{
+    return asleep;
+}
+
+long long Physics::getSkippedSteps() const
+{
+    return skippedSteps;
+}
+
+long long Physics::getStepCount() const
+{
+    return stepCount;
+}
+
+int Physics::getWallContacts() const
+{
+    return wallContacts;
+}
+
+CollisionMode Physics::getCollisionMode() const
+{
+    return collisionMode;
+}
+
+void checkSphereBounds(const WallSet& walls, glm::vec3& spherePosition, glm::vec3& sphereVelocity, int& wallContacts)
+{
+    const float radius = ballRadius;
+
+    // Vrifier les collisions avec les murs du parcours
+    wallContacts += collideWalls(walls, spherePosition, sphereVelocity);
+
+    // Vrifier les collisions avec le sol
+    if (spherePosition.y <= radius) {
+        spherePosition.y = radius;
+        sphereVelocity.y *= -dampingFactor;
+        if (std::abs(sphereVelocity.y) < minBounceSpeed) {
+            sphereVelocity.y = 0.0f;
+        }
+    }
+}
+
+bool checkHoleCollision(const glm::vec3& spherePosition, const glm::vec3& holePosition)
+{
+    float distance = glm::distance(spherePosition, holePosition);
+    return distance < holeRadius;
+}
+
+bool Physics::checkHoleCollision()
+{
+    return ::checkHoleCollision(ball.position, course->holePosition);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <glm.hpp>
+#include "course.h"
+
+// Constantes de la simulation. Les vitesses sont exprimes en units par pas fixe,
+// un pas fixe correspondant  l'ancienne frame de rendu (1/60 s)
+constexpr float ballRadius = 0.6f; // constexpr : donne aussi la taille du maillage de la balle, calcul  la compilation
+const float dampingFactor = 0.8f;
+const float gravity = 0.005f;
+const float minBounceSpeed = 0.001f;
+const float friction = 0.995f; // Friction
+const int subSteps = 10; // Nombre de sous-tapes pour la simulation
+extern const float subStepFriction; // friction^(1/subSteps), calcul une seule fois
+const float holeRadius = 1.5f;
+const float maxImpulseStrength = 2.0f;
+const float restSpeed = 0.0005f; // En dessous de cette vitesse la balle est considre  l'arrt
+const int sleepSteps = 30; // Pas conscutifs  l'arrt avant que la balle ne soit endormie (plus simule)
+
+const double fixedTimeStep = 1.0 / 60.0; // Dure d'un pas fixe de simulation
+const int maxStepsPerUpdate = 8; // Limite de pas par appel  step() pour viter la spirale de la mort
+const int maxContactsPerStep = 16; // Limite d'impacts rsolus par pas en collision continue
+const int maxPredictionSteps = 60 * 60; // Limite de pas simuls par une prdiction avant que la balle ne roule
+const int maxPredictionContacts = 256; // Limite d'impacts suivis analytiquement par une prdiction, au-del elle simule pas  pas
+
+enum CollisionMode
+{
+    DiscreteCollision,  // subSteps sous-tapes par pas, collisions testes  la fin de chacune
+    ContinuousCollision // Une seule tape par pas, la balle avance d'impact en impact (temps d'impact exacts)
+};
+
+glm::vec3 getShotDirection(float angleX, float angleY); // Direction de tir  partir des angles de la camra
+
+// Collisions de la balle avec les murs (et le sol) du parcours, pour une sous-tape
+void checkSphereBounds(const WallSet& walls, glm::vec3& spherePosition, glm::vec3& sphereVelocity, int& wallContacts);
+
+// La balle est-elle dans la zone de dtection du trou ?
+bool checkHoleCollision(const glm::vec3& spherePosition, const glm::vec3& holePosition);
+
+struct BallState
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+};
+
+struct ShotResult
+{
+    glm::vec3 finalPosition;
+    bool inHole;
+    int wallContacts;
+    int steps;
+};
+
+class Physics
+{
+
+public:
+
+    Physics();
+
+    void setCourse(const CourseLibrary& courses, int index);
+    void reset(); // Replace la balle au dpart du parcours actuel
+    void reset(const glm::vec3& position);
+    void applyImpulse(const glm::vec3& impulse);
+    void setCollisionMode(CollisionMode mode);
+
+    int step(double deltaTime); // Avance la simulation, retourne le nombre de pas fixes effectus
+    void fixedStep(); // Un seul pas fixe (fixedTimeStep)
+
+    const BallState& getBall() const;
+    const Course& getCourse() const;
+    bool isInHole() const;
+    bool isAtRest() const;
+    bool isAsleep() const; // Rveille par applyImpulse(), reset() ou setCourse()
+    int getWallContacts() const; // Nombre d'impacts contre les murs depuis le dernier reset
+    CollisionMode getCollisionMode() const;
+    long long getSkippedSteps() const; // Pas fixes vits pendant le sommeil, depuis la cration
+    long long getStepCount() const; // Pas fixes effectus (ou vits) depuis la cration
+
+    // Prdictions sans toucher  la simulation. Tant que la balle est en l'air elle est simule pas  pas,
+    // ds qu'elle roule au sol son mouvement est calcul analytiquement d'impact en impact
+    // (dcroissance exponentielle de la vitesse, trajectoire rectiligne entre deux murs).
+    // Mme modle que la collision continue, impacts compts de la mme faon.
+    ShotResult predictRest() const;
+    glm::vec3 predictRestPosition() const;
+    double timeToRest() const; // En secondes
+
+private:
+
+    BallState ball;
+    const Course* course;
+    WallSet walls;
+    double accumulator;
+    bool inHole;
+    int wallContacts;
+    CollisionMode collisionMode;
+    bool asleep;
+    int restSteps;
+    long long skippedSteps;
+    long long stepCount;
+
+    void discreteStep();
+    void continuousStep();
+    void bounceOnGround();
+    bool checkHoleCollision();
+};
+
+// Simule un tir complet depuis le dpart du parcours jusqu' l'arrt de la balle (ou maxSteps pas fixes)
+ShotResult simulateShot(const CourseLibrary& courses, int index, const glm::vec3& impulse, int maxSteps, CollisionMode mode);
+
+// Mme rsultat par prdiction analytique : cot proportionnel au nombre d'impacts et non au nombre de pas
+ShotResult predictShot(const CourseLibrary& courses, int index, const glm::vec3& impulse);
@@ -0,0 +1,234 @@
+#include "physics_thread.h"
+#include "profiler.h"
+#include <iostream>
+
+BallState interpolateBall(const PhysicsSnapshot& previous, const PhysicsSnapshot& current, double time)
+{
+    // Balle replace entre les deux pas : on ne la fait pas glisser de l'ancienne position  la nouvelle
+    if (previous.teleports != current.teleports || current.time <= previous.time)
+        return current.ball;
+
+    float alpha = static_cast<float>((time - previous.time) / (current.time - previous.time));
+    alpha = glm::clamp(alpha, 0.0f, 1.0f);
+
+    BallState ball;
+    ball.position = glm::mix(previous.ball.position, current.ball.position, alpha);
+    ball.velocity = glm::mix(previous.ball.velocity, current.ball.velocity, alpha);
+    return ball;
+}
+
+PhysicsThread::PhysicsThread()
+    : physics(nullptr), courses(nullptr), recorder(nullptr), player(nullptr), course(0), running(false),
+      pushedInputs(0), appliedInputs(0), courseLoads(0), teleports(0), droppedSteps(0)
+{
+}
+
+PhysicsThread::~PhysicsThread()
+{
+    stop();
+}
+
+void PhysicsThread::start(Physics& simulation, const CourseLibrary& library, int startCourse, ReplayRecorder* replayRecorder, ReplayPlayer* replayPlayer)
+{
+    stop();
+    physics = &simulation;
+    courses = &library;
+    recorder = replayRecorder;
+    player = replayPlayer;
+    pushedInputs = 0;
+    appliedInputs = 0;
+    courseLoads = 0;
+    teleports = 0;
+    droppedSteps = 0;
+    startTime = std::chrono::steady_clock::now();
+
+    // Parcours de dpart charg ici, avant le thread : le premier instantan est dj valide
+    applyInput(PhysicsInput{ PhysicsInputCourse, glm::vec3(0.0f), 0.0f, startCourse });
+    appliedInputs = 0; // Pas une entre du thread de rendu
+    publish(0.0);
+    snapshots.update();
+    current = snapshots.getFront();
+    previous = current;
+
+    running = true;
+    thread = std::thread(&PhysicsThread::run, this);
+}
+
+void PhysicsThread::stop()
+{
+    if (!thread.joinable())
+        return;
+    running = false;
+    thread.join();
+}
+
+bool PhysicsThread::isRunning() const
+{
+    return running;
+}
+
+bool PhysicsThread::pushInput(const PhysicsInput& input)
+{
+    if (!inputs.push(input))
+    {
+        std::cerr << "File des entres de la physique pleine, entre ignore" << std::endl;
+        return false;
+    }
+    if (input.type != PhysicsInputCamera)
+        ++pushedInputs;
+    return true;
+}
+
+unsigned int PhysicsThread::getPushedInputCount() const
+{
+    return pushedInputs;
+}
+
+bool PhysicsThread::updateSnapshot()
+{
+    if (!snapshots.update())
+        return false;
+    previous = current;
+    current = snapshots.getFront();
+    return true;
+}
+
+const PhysicsSnapshot& PhysicsThread::getSnapshot() const
+{
+    return current;
+}
+
+const PhysicsSnapshot& PhysicsThread::getPreviousSnapshot() const
+{
+    return previous;
+}
+
+double PhysicsThread::getTime() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int PhysicsThread::getCourse() const
+{
+    return course;
+}
+
+long long PhysicsThread::getDroppedSteps() const
+{
+    return droppedSteps;
+}
+
+void PhysicsThread::run()
+{
+    const std::chrono::steady_clock::duration stepDuration =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(fixedTimeStep));
+    const std::chrono::steady_clock::duration tickDuration = stepDuration / physicsTicksPerStep;
+    std::chrono::steady_clock::time_point nextTick = startTime;
+    long long scheduledTicks = 0;
+
+    while (running)
+    {
+        nextTick += tickDuration;
+        ++scheduledTicks;
+        bool stepDue = scheduledTicks % physicsTicksPerStep == 0;
+        bool changed = stepDue;
+
+        {
+            PROFILE_CPU("physics");
+
+            // En relecture, les entres du joueur sont ignores : seul l'enregistrement agit
+            PhysicsInput input;
+            while (inputs.pop(input))
+            {
+                if (!player)
+                {
+                    applyInput(input);
+                    changed |= input.type != PhysicsInputCamera;
+                }
+                else if (input.type != PhysicsInputCamera)
+                {
+                    ++appliedInputs;
+                    changed = true;
+                }
+            }
+
+            // Entre deux pas, seulement les entres
+            if (stepDue && player)
+            {
+                if (player->applyDueEvents(*physics, *courses, course))
+                {
+                    ++courseLoads;
+                    ++teleports;
+                }
+                if (physics->getStepCount() < player->getStepCount())
+                    physics->fixedStep();
+            }
+            else if (stepDue)
+            {
+                physics->fixedStep();
+            }
+        }
+        if (changed)
+            publish(scheduledTicks / physicsTicksPerStep * fixedTimeStep);
+
+        // Trop de retard (thread priv de processeur) : on abandonne des pas entiers plutt que de rattraper
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - nextTick > stepDuration * maxStepsPerUpdate)
+        {
+            long long late = (now - nextTick) / stepDuration;
+            droppedSteps += late;
+            scheduledTicks += late * physicsTicksPerStep;
+            nextTick += stepDuration * late;
+        }
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void PhysicsThread::applyInput(const PhysicsInput& input)
+{
+    if (input.type == PhysicsInputShot)
+    {
+        physics->applyImpulse(input.value);
+        if (recorder)
+            recorder->recordShot(*physics, input.value, input.duration);
+    }
+    else if (input.type == PhysicsInputReset)
+    {
+        physics->reset();
+        if (recorder)
+            recorder->recordReset(*physics);
+        ++teleports;
+    }
+    else if (input.type == PhysicsInputCourse)
+    {
+        course = input.course;
+        physics->setCourse(*courses, course);
+        if (recorder)
+            recorder->recordCourse(*physics, course);
+        ++courseLoads;
+        ++teleports;
+    }
+    else if (input.type == PhysicsInputCamera)
+    {
+        if (recorder)
+            recorder->recordCamera(*physics, input.value.x, input.value.y, input.value.z);
+        return; // Sans effet sur la partie
+    }
+    ++appliedInputs;
+}
+
+void PhysicsThread::publish(double time)
+{
+    PhysicsSnapshot& snapshot = snapshots.getBack();
+    snapshot.ball = physics->getBall();
+    snapshot.inHole = physics->isInHole();
+    snapshot.asleep = physics->isAsleep();
+    snapshot.course = course;
+    snapshot.stepCount = physics->getStepCount();
+    snapshot.time = time;
+    snapshot.inputCount = appliedInputs;
+    snapshot.courseLoads = courseLoads;
+    snapshot.teleports = teleports;
+    snapshot.camera = player ? player->getCamera() : ReplayCameraState{ 0.0f, 0.0f, 0.0f, false };
+    snapshots.publish();
+}
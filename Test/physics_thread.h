@@ -0,0 +1,197 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "physics.h"
+#include "replay.h"
+
+// Simulation sur son propre thread, au pas fixe (fixedTimeStep), indpendante du rendu.
+// Le thread tourne physicsTicksPerStep fois par pas (240 Hz) : les entres sont prises en compte
+//  chaque tour, les pas fixes restent au rythme de fixedTimeStep pour que la simulation et les
+// enregistrements, dats en pas, ne dpendent pas du thread.
+// Le thread de rendu envoie les entres (tir, remise  zro, parcours) par une file
+// producteur/consommateur uniques, et lit un instantan immuable de l'tat publi aprs chaque
+// pas ou entre par un triple tampon : aucun verrou, aucun des deux threads n'attend l'autre.
+//
+//     physicsThread.start(physics, courses, 0, &recorder, nullptr); // Charge aussi le parcours 0
+//     physicsThread.pushInput(PhysicsInput{ PhysicsInputShot, impulse, duration });
+//     ...
+//     const PhysicsSnapshot& snapshot = physicsThread.getSnapshot();
+//     ...
+//     physicsThread.stop(); // Avant de relire physics, recorder ou player
+//
+// Physics, le recorder et le player appartiennent au thread de simulation entre start() et stop().
+
+// Dernire valeur publie par un producteur, lue par un consommateur, sans verrou ni attente :
+// l'crivain remplit sa case puis l'change avec la case du milieu, le lecteur prend la case
+// du milieu seulement si elle a t publie depuis sa dernire lecture.
+template <typename T>
+class TripleBuffer
+{
+
+public:
+
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    T& getBack() { return slots[back]; }
+
+    // Rend la case d'criture visible du lecteur et en prend une autre
+    void publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Retourne true si une nouvelle valeur a t publie depuis le dernier appel
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & freshBit))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& getFront() const { return slots[front]; }
+
+private:
+
+    static const int freshBit = 4;
+    static const int indexMask = 3;
+
+    T slots[3];
+    int back;                   // crivain seulement
+    std::atomic<int> middle;    // Indice de la case change, freshBit si elle n'a pas encore t lue
+    int front;                  // Lecteur seulement
+};
+
+// File circulaire  un seul producteur et un seul consommateur, sans verrou.
+// Capacity doit tre une puissance de deux ; une case reste toujours vide.
+template <typename T, int Capacity>
+class SpscQueue
+{
+
+public:
+
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producteur : retourne false si la file est pleine
+    bool push(const T& value)
+    {
+        unsigned int position = tail.load(std::memory_order_relaxed);
+        unsigned int next = (position + 1) & (Capacity - 1);
+        if (next == head.load(std::memory_order_acquire))
+            return false;
+        items[position] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur : retourne false si la file est vide
+    bool pop(T& value)
+    {
+        unsigned int position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire))
+            return false;
+        value = items[position];
+        head.store((position + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+
+    static_assert((Capacity & (Capacity - 1)) == 0, "La capacit doit tre une puissance de deux");
+
+    T items[Capacity];
+    std::atomic<unsigned int> head;    // Prochaine case lue (consommateur)
+    std::atomic<unsigned int> tail;    // Prochaine case crite (producteur)
+};
+
+enum PhysicsInputType
+{
+    PhysicsInputShot,   // value : impulsion, duration : dure d'appui sur E (s)
+    PhysicsInputReset,
+    PhysicsInputCourse, // course : indice du parcours  charger
+    PhysicsInputCamera  // value : angleX, angleY, zoom, seulement pour l'enregistrement
+};
+
+struct PhysicsInput
+{
+    PhysicsInputType type;
+    glm::vec3 value;
+    float duration;
+    int course;
+};
+
+const int physicsInputCapacity = 64;
+const int physicsTicksPerStep = 4; // Tours du thread par pas fixe
+
+// tat publi aprs chaque pas, et aprs chaque entre applique entre deux pas
+struct PhysicsSnapshot
+{
+    BallState ball;
+    bool inHole;
+    bool asleep;
+    int course;
+    long long stepCount;
+    double time;                // Instant du dernier pas, horloge de PhysicsThread::getTime()
+    unsigned int inputCount;    // Entres de jeu (hors camra) appliques depuis start()
+    unsigned int courseLoads;   // Changements de parcours, relecture comprise
+    unsigned int teleports;     // Remises  zro et changements de parcours : pas d'interpolation  travers
+    ReplayCameraState camera;   // En relecture : camra enregistre
+};
+
+// Interpolation entre deux instantans successifs, pour un affichage fluide  tout rythme de rendu
+BallState interpolateBall(const PhysicsSnapshot& previous, const PhysicsSnapshot& current, double time);
+
+class PhysicsThread
+{
+
+public:
+
+    PhysicsThread();
+    ~PhysicsThread();
+
+    // recorder et player sont facultatifs ; avec un player, les entres viennent de l'enregistrement
+    void start(Physics& physics, const CourseLibrary& courses, int course, ReplayRecorder* recorder, ReplayPlayer* player);
+    void stop();
+    bool isRunning() const;
+
+    bool pushInput(const PhysicsInput& input); // Thread de rendu seulement
+    unsigned int getPushedInputCount() const; // Hors camra,  comparer  PhysicsSnapshot::inputCount
+
+    // Thread de rendu : reoit le dernier instantan publi, retourne true s'il est nouveau.
+    // getPreviousSnapshot() garde le prcdent pour l'interpolation.
+    bool updateSnapshot();
+    const PhysicsSnapshot& getSnapshot() const;
+    const PhysicsSnapshot& getPreviousSnapshot() const;
+
+    double getTime() const; // Secondes depuis start()
+    int getCourse() const;  // Aprs stop() : parcours final (relecture comprise)
+    long long getDroppedSteps() const; // Pas abandonns quand le thread a pris trop de retard
+
+private:
+
+    Physics* physics;
+    const CourseLibrary* courses;
+    ReplayRecorder* recorder;
+    ReplayPlayer* player;
+    int course;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::chrono::steady_clock::time_point startTime;
+
+    SpscQueue<PhysicsInput, physicsInputCapacity> inputs;
+    unsigned int pushedInputs;
+    unsigned int appliedInputs;
+    unsigned int courseLoads;
+    unsigned int teleports;
+    std::atomic<long long> droppedSteps;
+
+    TripleBuffer<PhysicsSnapshot> snapshots;
+    PhysicsSnapshot previous;
+    PhysicsSnapshot current;
+
+    void run();
+    void applyInput(const PhysicsInput& input);
+    void publish(double time);
+};
@@ -5,8 +5,15 @@ layout(location = 1) in vec3 aColor;
 out vec3 ourColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
 
 void main()
 {
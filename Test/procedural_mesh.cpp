@@ -0,0 +1,37 @@
+#include "procedural_mesh.h"
+
+void setMeshAttributes()
+{
+    glEnableVertexAttribArray(meshPositionLocation);
+    glVertexAttribPointer(meshPositionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, position));
+
+    glEnableVertexAttribArray(meshNormalLocation);
+    glVertexAttribPointer(meshNormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, normal));
+
+    glEnableVertexAttribArray(meshTexCoordLocation);
+    glVertexAttribPointer(meshTexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, texCoord));
+}
+
+void uploadMesh(const MeshVertex* vertices, size_t vertexCount, const GLuint* indices, size_t indexCount,
+    GlVertexArray& vao, GlBuffer& vbo, GlBuffer* ebo)
+{
+    vao.create();
+    glBindVertexArray(vao);
+
+    // Les tables sont dj dans leur disposition finale : envoyes directement depuis la mmoire statique
+    vbo.create();
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(MeshVertex) * vertexCount, vertices, GL_STATIC_DRAW);
+    vbo.setByteSize(sizeof(MeshVertex) * vertexCount);
+    setMeshAttributes();
+
+    if (indexCount > 0)
+    {
+        ebo->create();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indexCount, indices, GL_STATIC_DRAW);
+        ebo->setByteSize(sizeof(GLuint) * indexCount);
+    }
+
+    glBindVertexArray(0);
+}
@@ -0,0 +1,268 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include "frustum.h"
+#include "gl_resource.h"
+
+// Maillages procduraux (sphre, cylindre, disque) calculs entirement  la compilation :
+// les tables de sommets et d'indices sont des constexpr, ranges en mmoire statique et
+// envoyes telles quelles au GPU, sans trigonomtrie ni allocation au dmarrage.
+// Tous les maillages partagent le mme sommet entrelac (un seul tampon par maillage) ;
+// chaque niveau de dtail suit le prcdent dans ce tampon, avec ses indices  partir de 0.
+//
+//     constexpr SphereMeshData sphereMesh = buildSphereMesh<sphereMeshVertexCount, sphereMeshIndexCount>(
+//         ballRadius, sphereLodSectors, sphereLodStacks);
+//     uploadMesh(sphereMesh, sphereVAO, sphereVBO, sphereEBO);
+
+struct MeshVertex
+{
+    float position[3];
+    float normal[3];
+    float texCoord[2];
+};
+
+// Emplacements des attributs ; la normale vite 1 (couleur des shaders) et 3 (trane)
+const GLuint meshPositionLocation = 0;
+const GLuint meshTexCoordLocation = 2;
+const GLuint meshNormalLocation = 4;
+
+// Niveaux de dtail, du plus fin au plus grossier (voir selectLod())
+constexpr int sphereLodCount = 4;
+constexpr int sphereLodSectors[sphereLodCount] = { 36, 18, 10, 6 };
+constexpr int sphereLodStacks[sphereLodCount] = { 18, 9, 5, 3 };
+constexpr int cylinderLodCount = 3;
+constexpr int cylinderLodSegments[cylinderLodCount] = { 36, 16, 8 };
+constexpr int circleLodCount = 3;
+constexpr int circleLodSegments[circleLodCount] = { 36, 16, 8 };
+
+// Sommets, indices et niveaux de dtail d'un maillage
+template <int VertexCount, int IndexCount, int LodCount>
+struct MeshData
+{
+    MeshVertex vertices[VertexCount];
+    GLuint indices[IndexCount];
+    MeshLod lods[LodCount];
+};
+
+// Maillage non index (ventails de glDrawArrays)
+template <int VertexCount, int LodCount>
+struct MeshData<VertexCount, 0, LodCount>
+{
+    MeshVertex vertices[VertexCount];
+    MeshLod lods[LodCount];
+};
+
+// Trigonomtrie valuable  la compilation (la bibliothque standard ne l'est pas en C++14)
+constexpr double meshPi = 3.14159265358979323846;
+
+constexpr double meshSin(double angle)
+{
+    // Ramen dans [-pi, pi], puis srie de Taylor : l'erreur reste sous 1e-12
+    long long turns = (long long)(angle / (2.0 * meshPi) + (angle >= 0.0 ? 0.5 : -0.5));
+    double x = angle - turns * 2.0 * meshPi;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 14; ++n)
+    {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double meshCos(double angle)
+{
+    return meshSin(angle + meshPi / 2.0);
+}
+
+constexpr MeshVertex makeMeshVertex(double x, double y, double z, double nx, double ny, double nz, double u, double v)
+{
+    return MeshVertex{ { (float)x, (float)y, (float)z }, { (float)nx, (float)ny, (float)nz }, { (float)u, (float)v } };
+}
+
+// Tailles des tables, pour tous les niveaux d'une chane
+template <int LodCount>
+constexpr int sphereVertexCount(const int (&sectors)[LodCount], const int (&stacks)[LodCount])
+{
+    int count = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+        count += (sectors[lod] + 1) * (stacks[lod] + 1);
+    return count;
+}
+
+template <int LodCount>
+constexpr int sphereIndexCount(const int (&sectors)[LodCount], const int (&stacks)[LodCount])
+{
+    // Deux triangles par secteur, un seul sur les ranges des ples
+    int count = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+        count += 6 * sectors[lod] * (stacks[lod] - 1);
+    return count;
+}
+
+template <int LodCount>
+constexpr int cylinderVertexCount(const int (&segments)[LodCount])
+{
+    int count = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+        count += (segments[lod] + 1) * 2;
+    return count;
+}
+
+template <int LodCount>
+constexpr int cylinderIndexCount(const int (&segments)[LodCount])
+{
+    int count = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+        count += segments[lod] * 6;
+    return count;
+}
+
+template <int LodCount>
+constexpr int circleVertexCount(const int (&segments)[LodCount])
+{
+    int count = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+        count += segments[lod] + 2;
+    return count;
+}
+
+// Sphre centre sur l'origine, ples sur l'axe z ; la premire et la dernire colonne d'une
+// range ont la mme position mais pas les mmes coordonnes de texture
+template <int VertexCount, int IndexCount, int LodCount>
+constexpr MeshData<VertexCount, IndexCount, LodCount> buildSphereMesh(double radius, const int (&sectors)[LodCount], const int (&stacks)[LodCount])
+{
+    MeshData<VertexCount, IndexCount, LodCount> mesh{};
+    int vertex = 0;
+    int index = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+    {
+        mesh.lods[lod] = MeshLod{ sectors[lod], vertex, (GLuint)index, 0 };
+
+        for (int i = 0; i <= stacks[lod]; ++i)
+        {
+            double stackAngle = meshPi / 2 - i * meshPi / stacks[lod];
+            double xy = meshCos(stackAngle);
+            double z = meshSin(stackAngle);
+            for (int j = 0; j <= sectors[lod]; ++j)
+            {
+                double sectorAngle = j * 2 * meshPi / sectors[lod];
+                double x = xy * meshCos(sectorAngle);
+                double y = xy * meshSin(sectorAngle);
+                mesh.vertices[vertex++] = makeMeshVertex(radius * x, radius * y, radius * z, x, y, z,
+                    (double)j / sectors[lod], (double)i / stacks[lod]);
+            }
+        }
+
+        for (int i = 0; i < stacks[lod]; ++i)
+        {
+            GLuint k1 = i * (sectors[lod] + 1);
+            GLuint k2 = k1 + sectors[lod] + 1;
+            for (int j = 0; j < sectors[lod]; ++j, ++k1, ++k2)
+            {
+                if (i != 0)
+                {
+                    mesh.indices[index++] = k1;
+                    mesh.indices[index++] = k2;
+                    mesh.indices[index++] = k1 + 1;
+                }
+                if (i != stacks[lod] - 1)
+                {
+                    mesh.indices[index++] = k1 + 1;
+                    mesh.indices[index++] = k2;
+                    mesh.indices[index++] = k2 + 1;
+                }
+            }
+        }
+        mesh.lods[lod].count = index - (int)mesh.lods[lod].firstIndex;
+    }
+    return mesh;
+}
+
+// Cylindre ouvert, de y = 0  y = height ; sommets du bas et du haut alterns
+template <int VertexCount, int IndexCount, int LodCount>
+constexpr MeshData<VertexCount, IndexCount, LodCount> buildCylinderMesh(double radius, double height, const int (&segments)[LodCount])
+{
+    MeshData<VertexCount, IndexCount, LodCount> mesh{};
+    int vertex = 0;
+    int index = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+    {
+        mesh.lods[lod] = MeshLod{ segments[lod], vertex, (GLuint)index, segments[lod] * 6 };
+
+        for (int i = 0; i <= segments[lod]; ++i)
+        {
+            double angle = i * 2 * meshPi / segments[lod];
+            double x = meshCos(angle);
+            double z = meshSin(angle);
+            double u = (double)i / segments[lod];
+            mesh.vertices[vertex++] = makeMeshVertex(radius * x, 0.0, radius * z, x, 0.0, z, u, 0.0);
+            mesh.vertices[vertex++] = makeMeshVertex(radius * x, height, radius * z, x, 0.0, z, u, 1.0);
+        }
+
+        for (GLuint i = 0; i < (GLuint)segments[lod] * 2; i += 2)
+        {
+            mesh.indices[index++] = i;
+            mesh.indices[index++] = i + 1;
+            mesh.indices[index++] = i + 2;
+
+            mesh.indices[index++] = i + 1;
+            mesh.indices[index++] = i + 3;
+            mesh.indices[index++] = i + 2;
+        }
+    }
+    return mesh;
+}
+
+// Disque horizontal dessin en ventail : le centre puis le bord, ferm sur son premier sommet
+template <int VertexCount, int LodCount>
+constexpr MeshData<VertexCount, 0, LodCount> buildCircleMesh(double radius, const int (&segments)[LodCount])
+{
+    MeshData<VertexCount, 0, LodCount> mesh{};
+    int vertex = 0;
+    for (int lod = 0; lod < LodCount; ++lod)
+    {
+        mesh.lods[lod] = MeshLod{ segments[lod], vertex, 0, segments[lod] + 2 };
+
+        mesh.vertices[vertex++] = makeMeshVertex(0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.5, 0.5);
+        for (int i = 0; i <= segments[lod]; ++i)
+        {
+            double angle = i * 2 * meshPi / segments[lod];
+            double x = meshCos(angle);
+            double z = meshSin(angle);
+            mesh.vertices[vertex++] = makeMeshVertex(radius * x, 0.0, radius * z, 0.0, 1.0, 0.0, 0.5 + 0.5 * x, 0.5 + 0.5 * z);
+        }
+    }
+    return mesh;
+}
+
+constexpr int sphereMeshVertexCount = sphereVertexCount(sphereLodSectors, sphereLodStacks);
+constexpr int sphereMeshIndexCount = sphereIndexCount(sphereLodSectors, sphereLodStacks);
+typedef MeshData<sphereMeshVertexCount, sphereMeshIndexCount, sphereLodCount> SphereMeshData;
+
+constexpr int cylinderMeshVertexCount = cylinderVertexCount(cylinderLodSegments);
+constexpr int cylinderMeshIndexCount = cylinderIndexCount(cylinderLodSegments);
+typedef MeshData<cylinderMeshVertexCount, cylinderMeshIndexCount, cylinderLodCount> CylinderMeshData;
+
+constexpr int circleMeshVertexCount = circleVertexCount(circleLodSegments);
+typedef MeshData<circleMeshVertexCount, 0, circleLodCount> CircleMeshData;
+
+// Attributs du sommet entrelac, lus dans le tampon li  GL_ARRAY_BUFFER
+void setMeshAttributes();
+
+// Cre le VAO, le tampon de sommets et, si indexCount > 0, le tampon d'indices (attach au VAO) ;
+// les objets dj possds par ces poignes sont supprims
+void uploadMesh(const MeshVertex* vertices, size_t vertexCount, const GLuint* indices, size_t indexCount,
+    GlVertexArray& vao, GlBuffer& vbo, GlBuffer* ebo);
+
+template <int VertexCount, int IndexCount, int LodCount>
+void uploadMesh(const MeshData<VertexCount, IndexCount, LodCount>& mesh, GlVertexArray& vao, GlBuffer& vbo, GlBuffer& ebo)
+{
+    uploadMesh(mesh.vertices, VertexCount, mesh.indices, IndexCount, vao, vbo, &ebo);
+}
+
+template <int VertexCount, int LodCount>
+void uploadMesh(const MeshData<VertexCount, 0, LodCount>& mesh, GlVertexArray& vao, GlBuffer& vbo)
+{
+    uploadMesh(mesh.vertices, VertexCount, nullptr, 0, vao, vbo, nullptr);
+}
@@ -0,0 +1,292 @@
+#include "profiler.h"
+
+#ifdef GOLF_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+static int64_t clockNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const int64_t profilerEpoch = clockNanoseconds();
+Profiler profiler;
+
+// Numro court du thread appelant, pour les lignes du Chrome trace
+static int getThreadNumber()
+{
+    static std::atomic<int> threadCount(0);
+    thread_local int thread = threadCount++;
+    return thread;
+}
+
+Profiler::Profiler()
+    : frameIndex(0), frameStart(0), frameSection(-1), recording(false), firstRecordedFrame(0)
+{
+    sections.reserve(maxProfileSections);
+    frameSection = getSection("frame");
+}
+
+int Profiler::getSection(const char* name, bool gpu)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        if (sections[i].name == name && sections[i].gpu == gpu)
+            return (int)i;
+    }
+
+    if ((int)sections.size() >= maxProfileSections)
+    {
+        std::cerr << "Profileur : trop de sections, " << name << " est ignore" << std::endl;
+        return -1;
+    }
+
+    ProfileSection section;
+    section.name = name;
+    section.gpu = gpu;
+    section.current = 0.0;
+    section.history.assign(profileHistoryFrames, 0.0f);
+    sections.push_back(section);
+    for (std::vector<float>& values : frames)
+        values.resize(sections.size(), 0.0f);
+    return (int)sections.size() - 1;
+}
+
+int Profiler::getSectionCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)sections.size();
+}
+
+const char* Profiler::getSectionName(int section) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return sections[section].name.c_str();
+}
+
+bool Profiler::isGpuSection(int section) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return sections[section].gpu;
+}
+
+int64_t Profiler::now() const
+{
+    return clockNanoseconds() - profilerEpoch;
+}
+
+void Profiler::addCpuTime(int section, int64_t start, int64_t end)
+{
+    if (section < 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    sections[section].current += (end - start) / 1.0e6;
+
+    if (recording && events.size() < maxTraceEvents)
+    {
+        TraceEvent event;
+        event.section = section;
+        event.thread = getThreadNumber();
+        event.start = start;
+        event.duration = end - start;
+        events.push_back(event);
+    }
+}
+
+// Appel sous le verrou. La ligne est cre au besoin : un temps GPU lu par PROFILE_GPU_COLLECT()
+// arrive souvent avant que endFrame() ait clos son image
+std::vector<float>* Profiler::getRecordedFrame(int64_t frame)
+{
+    if (!recording || frame < firstRecordedFrame)
+        return nullptr;
+
+    size_t row = (size_t)(frame - firstRecordedFrame);
+    while (frames.size() <= row && frames.size() < maxTraceEvents)
+    {
+        frames.push_back(std::vector<float>(sections.size(), 0.0f));
+        frameStarts.push_back(frameStart); // Seule l'image en cours peut manquer : c'est son dbut
+    }
+    return row < frames.size() ? &frames[row] : nullptr;
+}
+
+// Appel sous le verrou
+void Profiler::recordValue(int section, double milliseconds, int64_t frame)
+{
+    ProfileSection& target = sections[section];
+    target.history[frame % profileHistoryFrames] = (float)milliseconds;
+
+    std::vector<float>* values = getRecordedFrame(frame);
+    if (values)
+        (*values)[section] += (float)milliseconds;
+}
+
+void Profiler::addSample(int section, double milliseconds, int64_t frame)
+{
+    if (section < 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frameIndex - frame < profileHistoryFrames)
+        recordValue(section, milliseconds, frame);
+}
+
+void Profiler::endFrame()
+{
+    int64_t end = now();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frameIndex > 0)
+        sections[frameSection].current = (end - frameStart) / 1.0e6;
+    getRecordedFrame(frameIndex); // Avec le dbut de l'image, mme sans temps GPU
+    frameStart = end;
+
+    // Les sections GPU sont remplies par addSample(), avec l'image de leur mesure
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        ProfileSection& section = sections[i];
+        if (section.gpu)
+            continue;
+
+        recordValue((int)i, section.current, frameIndex);
+        section.current = 0.0;
+    }
+    ++frameIndex;
+}
+
+int64_t Profiler::getFrameIndex() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return frameIndex;
+}
+
+float Profiler::getAverage(int section) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::vector<float>& history = sections[section].history;
+    size_t count = std::min((size_t)frameIndex, history.size());
+    if (count == 0)
+        return 0.0f;
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+        sum += history[i];
+    return sum / count;
+}
+
+float Profiler::getPercentile(int section, float ratio) const
+{
+    std::vector<float> values;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::vector<float>& history = sections[section].history;
+        values.assign(history.begin(), history.begin() + std::min((size_t)frameIndex, history.size()));
+    }
+    if (values.empty())
+        return 0.0f;
+
+    size_t rank = std::min(values.size() - 1, (size_t)(ratio * (values.size() - 1) + 0.5f));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+std::string Profiler::getSummary() const
+{
+    std::string summary;
+    char text[96];
+    int count = getSectionCount();
+    for (int i = 0; i < count; ++i)
+    {
+        std::snprintf(text, sizeof(text), "%s%s%s %.2f/%.2f", i > 0 ? " | " : "", getSectionName(i), isGpuSection(i) ? " (GPU)" : "",
+            getAverage(i), getPercentile(i, 0.99f));
+        summary += text;
+    }
+    return summary + " ms (moy./p99)";
+}
+
+void Profiler::setRecording(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (enabled && !recording)
+    {
+        events.clear();
+        frames.clear();
+        frameStarts.clear();
+        firstRecordedFrame = frameIndex;
+    }
+    recording = enabled;
+}
+
+bool Profiler::writeChromeTrace(const char* path) const
+{
+    std::ofstream trace(path);
+    if (!trace.is_open())
+    {
+        std::cerr << "Impossible d'crire " << path << std::endl;
+        return false;
+    }
+
+    // Format "Trace Event" : des vnements complets ("X"), horodats en microsecondes
+    std::lock_guard<std::mutex> lock(mutex);
+    trace << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const TraceEvent& event = events[i];
+        char line[192];
+        std::snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            sections[event.section].name.c_str(), event.thread, event.start / 1000.0, event.duration / 1000.0, i + 1 < events.size() ? "," : "");
+        trace << line;
+    }
+
+    // Temps GPU : compteurs ("C") poss au dbut de leur image, la dure exacte du travail GPU
+    // n'ayant pas d'horodatage CPU
+    bool first = events.empty();
+    for (size_t frame = 0; frame < frames.size(); ++frame)
+    {
+        for (size_t i = 0; i < sections.size() && i < frames[frame].size(); ++i)
+        {
+            if (!sections[i].gpu)
+                continue;
+            char line[192];
+            std::snprintf(line, sizeof(line), "%s{\"name\":\"%s (GPU)\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"ms\":%.4f}}\n",
+                first ? "" : ",", sections[i].name.c_str(), frameStarts[frame] / 1000.0, frames[frame][i]);
+            trace << line;
+            first = false;
+        }
+    }
+    trace << "],\"displayTimeUnit\":\"ms\"}\n";
+    return trace.good();
+}
+
+bool Profiler::writeCsv(const char* path) const
+{
+    std::ofstream csv(path);
+    if (!csv.is_open())
+    {
+        std::cerr << "Impossible d'crire " << path << std::endl;
+        return false;
+    }
+
+    // Les temps GPU arrivent quelques images plus tard : les dernires lignes peuvent en manquer
+    std::lock_guard<std::mutex> lock(mutex);
+    csv << "frame";
+    for (const ProfileSection& section : sections)
+        csv << "," << section.name << (section.gpu ? "_gpu_ms" : "_ms");
+    csv << "\n";
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        csv << firstRecordedFrame + (int64_t)i;
+        for (size_t j = 0; j < sections.size(); ++j)
+            csv << "," << (j < frames[i].size() ? frames[i][j] : 0.0f);
+        csv << "\n";
+    }
+    return csv.good();
+}
+
+#endif
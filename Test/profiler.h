@@ -0,0 +1,120 @@
+#pragma once
+
+// Profileur d'images : chronomtres CPU par porte, moyennes glissantes et p99 par section,
+// export CSV et Chrome trace (chrome://tracing, Perfetto). Les temps GPU viennent de
+// gpu_profiler.h. Tout disparat sans GOLF_PROFILE : les macros PROFILE_* ne gnrent alors
+// aucun code, on peut donc les laisser dans une version finale.
+//
+//     void drawTrail()
+//     {
+//         PROFILE_CPU("drawTrail");
+//         ...
+//     }
+
+#ifdef GOLF_PROFILE
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+const int profileHistoryFrames = 240;   // Fentre des moyennes glissantes (4 s  60 images/s)
+const int maxProfileSections = 32;
+const size_t maxTraceEvents = 1 << 20;  // Au-del, l'enregistrement s'arrte (environ 24 Mo)
+
+// Un appel chronomtr, pour l'export Chrome trace
+struct TraceEvent
+{
+    int section;
+    int thread;
+    int64_t start;          // Nanosecondes depuis la cration du profileur
+    int64_t duration;
+};
+
+struct ProfileSection
+{
+    std::string name;
+    bool gpu;
+    double current;                 // Cumul de l'image en cours (ms)
+    std::vector<float> history;     // Dernires images, tampon circulaire (ms)
+};
+
+class Profiler
+{
+
+public:
+
+    Profiler();
+
+    // Les sections sont cres au premier appel et gardes pour toute la dure du programme
+    int getSection(const char* name, bool gpu = false);
+    int getSectionCount() const;
+    const char* getSectionName(int section) const;
+    bool isGpuSection(int section) const;
+
+    int64_t now() const; // Nanosecondes depuis la cration du profileur
+    void addCpuTime(int section, int64_t start, int64_t end);
+    void addSample(int section, double milliseconds, int64_t frame); // Temps GPU, relu quelques images plus tard
+    void endFrame(); // Clt l'image : les cumuls passent dans l'historique
+
+    int64_t getFrameIndex() const;
+    float getAverage(int section) const;
+    float getPercentile(int section, float ratio) const;
+    std::string getSummary() const; // Moyenne et p99 de chaque section, sur une ligne
+
+    // Enregistrement complet (appels et images) pour writeChromeTrace() et writeCsv()
+    void setRecording(bool enabled);
+    bool writeChromeTrace(const char* path) const;
+    bool writeCsv(const char* path) const; // Une ligne par image, une colonne par section
+
+private:
+
+    mutable std::mutex mutex; // La physique peut tourner sur un autre thread
+    std::vector<ProfileSection> sections;
+    int64_t frameIndex;
+    int64_t frameStart;
+    int frameSection;
+
+    bool recording;
+    int64_t firstRecordedFrame;
+    std::vector<TraceEvent> events;
+    std::vector<std::vector<float> > frames; // Valeurs de chaque section pour chaque image enregistre
+    std::vector<int64_t> frameStarts; // Dbut de chaque image enregistre (ns)
+
+    std::vector<float>* getRecordedFrame(int64_t frame);
+    void recordValue(int section, double milliseconds, int64_t frame);
+};
+
+extern Profiler profiler;
+
+// Chronomtre CPU d'une porte
+class ProfileScope
+{
+
+public:
+
+    explicit ProfileScope(int section) : section(section), start(profiler.now()) {}
+    ~ProfileScope() { profiler.addCpuTime(section, start, profiler.now()); }
+
+private:
+
+    int section;
+    int64_t start;
+};
+
+#define GOLF_PROFILE_JOIN2(a, b) a##b
+#define GOLF_PROFILE_JOIN(a, b) GOLF_PROFILE_JOIN2(a, b)
+
+// La section est cherche une seule fois, au premier passage
+#define PROFILE_CPU(name) \
+    static const int GOLF_PROFILE_JOIN(profileSection, __LINE__) = profiler.getSection(name); \
+    ProfileScope GOLF_PROFILE_JOIN(profileScope, __LINE__)(GOLF_PROFILE_JOIN(profileSection, __LINE__))
+
+#define PROFILE_END_FRAME() profiler.endFrame()
+
+#else
+
+#define PROFILE_CPU(name)
+#define PROFILE_END_FRAME()
+
+#endif
@@ -0,0 +1,206 @@
+#include "render_queue.h"
+#include <gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+
+int RenderStats::getStateChanges() const
+{
+    return programBinds + vaoBinds + materialBinds + modelUploads;
+}
+
+RenderQueue::RenderQueue()
+    : currentProgram(0), currentVAO(0), currentMaterial(0), modelProgram(0), currentModel(1.0f)
+{
+    std::memset(&stats, 0, sizeof(stats));
+    materials.push_back(nullptr); // Matriau 0 : rien  rgler
+    materialCleanups.push_back(nullptr);
+}
+
+void RenderQueue::setMaterial(int material, MaterialSetup setup, MaterialSetup cleanup)
+{
+    if ((int)materials.size() <= material)
+    {
+        materials.resize(material + 1, nullptr);
+        materialCleanups.resize(material + 1, nullptr);
+    }
+    materials[material] = setup;
+    materialCleanups[material] = cleanup;
+}
+
+void RenderQueue::leaveMaterial()
+{
+    if (materialCleanups[currentMaterial])
+        materialCleanups[currentMaterial]();
+    currentMaterial = 0;
+}
+
+void RenderQueue::submitArrays(int layer, GLuint program, GLuint vao, GLint modelLoc, const glm::mat4& model, GLenum mode, GLint first, GLsizei count, int material)
+{
+    RenderItem item;
+    item.layer = layer;
+    item.program = program;
+    item.vao = vao;
+    item.material = material;
+    item.modelLoc = modelLoc;
+    item.model = model;
+    item.mode = mode;
+    item.indexed = false;
+    item.first = first;
+    item.firstIndex = 0;
+    item.count = count;
+    item.instanceCount = 0;
+    item.baseInstance = 0;
+    submit(item);
+}
+
+void RenderQueue::submitElements(int layer, GLuint program, GLuint vao, GLint modelLoc, const glm::mat4& model, GLenum mode, GLint baseVertex, GLuint firstIndex, GLsizei count,
+    GLsizei instanceCount, GLuint baseInstance, int material)
+{
+    RenderItem item;
+    item.layer = layer;
+    item.program = program;
+    item.vao = vao;
+    item.material = material;
+    item.modelLoc = modelLoc;
+    item.model = model;
+    item.mode = mode;
+    item.indexed = true;
+    item.first = baseVertex;
+    item.firstIndex = firstIndex;
+    item.count = count;
+    item.instanceCount = instanceCount;
+    item.baseInstance = baseInstance;
+    submit(item);
+}
+
+void RenderQueue::submit(RenderItem& item)
+{
+    if (item.count <= 0)
+        return;
+
+    // Couche, puis programme, VAO et matriau ; l'ordre de soumission dpartage le reste
+    item.key = ((uint64_t)(item.layer & 0xF) << 60)
+        | ((uint64_t)(item.program & 0xFFFF) << 44)
+        | ((uint64_t)(item.vao & 0xFFFF) << 28)
+        | ((uint64_t)(item.material & 0xFF) << 20)
+        | (uint64_t)(items.size() & 0xFFFFF);
+    items.push_back(item);
+}
+
+void RenderQueue::bind(const RenderItem& item)
+{
+    if (item.program != currentProgram)
+    {
+        leaveMaterial(); // Les uniformes du matriau appartiennent au programme
+        glUseProgram(item.program);
+        currentProgram = item.program;
+        ++stats.programBinds;
+    }
+
+    if (item.vao != currentVAO)
+    {
+        glBindVertexArray(item.vao);
+        currentVAO = item.vao;
+        ++stats.vaoBinds;
+    }
+
+    if (item.material != currentMaterial)
+    {
+        leaveMaterial();
+        if (materials[item.material])
+            materials[item.material]();
+        currentMaterial = item.material;
+        ++stats.materialBinds;
+    }
+
+    if (item.modelLoc >= 0 && (modelProgram != item.program || item.model != currentModel))
+    {
+        glUniformMatrix4fv(item.modelLoc, 1, GL_FALSE, glm::value_ptr(item.model));
+        modelProgram = item.program;
+        currentModel = item.model;
+        ++stats.modelUploads;
+    }
+}
+
+// Mme programme, VAO, matriau et matrice : un seul glMultiDraw* suffit
+bool RenderQueue::canMerge(const RenderItem& a, const RenderItem& b) const
+{
+    return a.program == b.program && a.vao == b.vao && a.material == b.material && a.mode == b.mode
+        && a.indexed == b.indexed && a.instanceCount == 0 && b.instanceCount == 0
+        && (a.modelLoc < 0 || a.model == b.model);
+}
+
+void RenderQueue::draw(const RenderItem* begin, const RenderItem* end)
+{
+    const RenderItem& item = *begin;
+    size_t count = end - begin;
+    ++stats.drawCalls;
+
+    if (count == 1)
+    {
+        const void* offset = (const void*)(sizeof(GLuint) * item.firstIndex);
+        if (!item.indexed)
+            glDrawArrays(item.mode, item.first, item.count);
+        else if (item.baseInstance > 0)
+            glDrawElementsInstancedBaseVertexBaseInstance(item.mode, item.count, GL_UNSIGNED_INT, offset, item.instanceCount, item.first, item.baseInstance);
+        else if (item.instanceCount > 0)
+            glDrawElementsInstancedBaseVertex(item.mode, item.count, GL_UNSIGNED_INT, offset, item.instanceCount, item.first);
+        else if (item.first != 0)
+            glDrawElementsBaseVertex(item.mode, item.count, GL_UNSIGNED_INT, offset, item.first);
+        else
+            glDrawElements(item.mode, item.count, GL_UNSIGNED_INT, offset);
+        return;
+    }
+
+    stats.mergedItems += (int)count;
+    firsts.clear();
+    counts.clear();
+    offsets.clear();
+    for (const RenderItem* it = begin; it != end; ++it)
+    {
+        firsts.push_back(it->first);
+        counts.push_back(it->count);
+        offsets.push_back((const void*)(sizeof(GLuint) * it->firstIndex));
+    }
+
+    if (item.indexed)
+        glMultiDrawElementsBaseVertex(item.mode, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)count, firsts.data());
+    else
+        glMultiDrawArrays(item.mode, firsts.data(), counts.data(), (GLsizei)count);
+}
+
+void RenderQueue::flush()
+{
+    std::memset(&stats, 0, sizeof(stats));
+    stats.items = (int)items.size();
+
+    std::sort(items.begin(), items.end(), [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+
+    // Les liaisons faites hors de la file (mise  jour des tampons...) ne sont pas suivies
+    currentProgram = 0;
+    currentVAO = 0;
+    currentMaterial = 0;
+    modelProgram = 0;
+
+    size_t i = 0;
+    while (i < items.size())
+    {
+        size_t j = i + 1;
+        while (j < items.size() && canMerge(items[i], items[j]))
+            ++j;
+
+        bind(items[i]);
+        draw(&items[i], &items[0] + j);
+        i = j;
+    }
+
+    leaveMaterial();
+    glBindVertexArray(0);
+    glUseProgram(0);
+    items.clear();
+}
+
+const RenderStats& RenderQueue::getStats() const
+{
+    return stats;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// File de rendu : les fonctions draw*() soumettent des lments au lieu de dessiner.
+// flush() les trie par (couche, programme, VAO, matriau), ne refait que les liaisons qui
+// changent rellement et regroupe les lments compatibles en un seul glMultiDraw*.
+
+enum RenderLayer
+{
+    SceneLayer,   // Objets 3D
+    OverlayLayer  // lments 2D dessins par-dessus (jauge, texte)
+};
+
+// Rglage des uniformes propres  un matriau, appel quand le matriau change ; le nettoyage
+// ventuel (fusion, texture...) est appel quand la file passe  un autre matriau
+typedef void (*MaterialSetup)();
+
+struct RenderItem
+{
+    uint64_t key;           // Cl de tri, calcule par submit()
+    int layer;              // RenderLayer
+    GLuint program;
+    GLuint vao;
+    int material;           // 0 : aucun rglage
+    GLint modelLoc;         // -1 si le programme n'a pas de matrice model
+    glm::mat4 model;
+    GLenum mode;
+    bool indexed;           // glDrawElements* (GL_UNSIGNED_INT) ou glDrawArrays*
+    GLint first;            // Premier sommet, ou sommet de base pour un dessin index
+    GLuint firstIndex;
+    GLsizei count;
+    GLsizei instanceCount;  // 0 : dessin non instanci
+    GLuint baseInstance;    // Premire instance (GL_ARB_base_instance)
+};
+
+// Compteurs de la dernire image
+struct RenderStats
+{
+    int items;              // lments soumis
+    int drawCalls;          // Commandes de dessin envoyes (un glMultiDraw* compte pour une)
+    int mergedItems;        // lments dessins dans un glMultiDraw* avec d'autres
+    int programBinds;
+    int vaoBinds;
+    int materialBinds;
+    int modelUploads;
+
+    int getStateChanges() const;
+};
+
+class RenderQueue
+{
+
+public:
+
+    RenderQueue();
+
+    void setMaterial(int material, MaterialSetup setup, MaterialSetup cleanup = nullptr);
+
+    void submitArrays(int layer, GLuint program, GLuint vao, GLint modelLoc, const glm::mat4& model, GLenum mode, GLint first, GLsizei count, int material = 0);
+    void submitElements(int layer, GLuint program, GLuint vao, GLint modelLoc, const glm::mat4& model, GLenum mode, GLint baseVertex, GLuint firstIndex, GLsizei count,
+        GLsizei instanceCount = 0, GLuint baseInstance = 0, int material = 0);
+
+    void flush(); // Trie, dessine et vide la file ; les liaisons sont remises  zro  la fin
+    const RenderStats& getStats() const;
+
+private:
+
+    std::vector<RenderItem> items;
+    std::vector<MaterialSetup> materials;
+    std::vector<MaterialSetup> materialCleanups;
+    RenderStats stats;
+
+    // Cache d'tat pendant flush()
+    GLuint currentProgram;
+    GLuint currentVAO;
+    int currentMaterial;
+    GLuint modelProgram;    // Programme dont la matrice model est connue
+    glm::mat4 currentModel;
+
+    // Tampons des glMultiDraw*
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+
+    void submit(RenderItem& item);
+    void bind(const RenderItem& item);
+    void leaveMaterial();
+    bool canMerge(const RenderItem& a, const RenderItem& b) const;
+    void draw(const RenderItem* begin, const RenderItem* end);
+};
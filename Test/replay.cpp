@@ -0,0 +1,266 @@
+#include "replay.h"
+#include "profiler.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char replayMagic[4] = { 'G', 'R', 'E', 'C' };
+static const uint32_t replayVersion = 2; // 2 : vnements camra ; la version 1 (sans camra) reste lisible
+
+ReplayRecorder::ReplayRecorder()
+{
+    recording = false;
+}
+
+void ReplayRecorder::start(const char* newPath)
+{
+    path = newPath;
+    recording = true;
+    events.clear();
+}
+
+bool ReplayRecorder::isRecording() const
+{
+    return recording;
+}
+
+void ReplayRecorder::record(const Physics& physics, ReplayEventType type, float x, float y, float z, float w)
+{
+    if (!recording)
+        return;
+
+    ReplayEvent event;
+    event.step = (uint32_t)physics.getStepCount();
+    event.type = type;
+    event.values[0] = x;
+    event.values[1] = y;
+    event.values[2] = z;
+    event.values[3] = w;
+    events.push_back(event);
+}
+
+void ReplayRecorder::recordShot(const Physics& physics, const glm::vec3& impulse, float pressDuration)
+{
+    record(physics, ReplayShot, impulse.x, impulse.y, impulse.z, pressDuration);
+}
+
+void ReplayRecorder::recordReset(const Physics& physics)
+{
+    record(physics, ReplayReset, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void ReplayRecorder::recordCourse(const Physics& physics, int course)
+{
+    record(physics, ReplayCourse, (float)course, 0.0f, 0.0f, 0.0f);
+}
+
+void ReplayRecorder::recordCamera(const Physics& physics, float angleX, float angleY, float zoom)
+{
+    record(physics, ReplayCamera, angleX, angleY, zoom, 0.0f);
+}
+
+bool ReplayRecorder::save(const Physics& physics, int course) const
+{
+    if (!recording)
+        return false;
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Impossible d'crire " << path << std::endl;
+        return false;
+    }
+
+    ReplayHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, replayMagic, sizeof(replayMagic));
+    header.version = replayVersion;
+    header.eventCount = (uint32_t)events.size();
+    header.stepCount = (uint32_t)physics.getStepCount();
+    header.finalCourse = course;
+    header.finalInHole = physics.isInHole() ? 1 : 0;
+    header.finalBall = physics.getBall();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(events.data()), events.size() * sizeof(ReplayEvent));
+    return file.good();
+}
+
+ReplayPlayer::ReplayPlayer()
+{
+    std::memset(&header, 0, sizeof(header));
+    nextEvent = 0;
+    accumulator = 0.0;
+    loaded = false;
+    camera = ReplayCameraState{ 0.0f, 0.0f, 0.0f, false };
+}
+
+bool ReplayPlayer::load(const char* path, const CourseLibrary& courses)
+{
+    loaded = false;
+    nextEvent = 0;
+    accumulator = 0.0;
+    camera.valid = false;
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Impossible d'ouvrir " << path << std::endl;
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, replayMagic, sizeof(replayMagic)) != 0 || (header.version != 1 && header.version != replayVersion))
+    {
+        std::cerr << path << " n'est pas un enregistrement valide" << std::endl;
+        return false;
+    }
+
+    // Nombre d'vnements born par la taille du fichier avant d'allouer
+    std::streamoff eventsStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff eventsSize = file.tellg() - eventsStart;
+    file.seekg(eventsStart);
+    if (eventsSize < 0 || (uint64_t)header.eventCount * sizeof(ReplayEvent) > (uint64_t)eventsSize)
+    {
+        std::cerr << path << " est tronqu" << std::endl;
+        return false;
+    }
+
+    events.resize(header.eventCount);
+    file.read(reinterpret_cast<char*>(events.data()), events.size() * sizeof(ReplayEvent));
+    if (!file)
+    {
+        std::cerr << path << " est tronqu" << std::endl;
+        return false;
+    }
+
+    // Les indices de parcours viennent du fichier : ils doivent exister dans la bibliothque charge
+    int courseCount = courses.getCourseCount();
+    bool validCourses = header.finalCourse >= 0 && header.finalCourse < courseCount;
+    for (const ReplayEvent& event : events)
+    {
+        if (event.type == ReplayCourse && !(event.values[0] >= 0.0f && event.values[0] < (float)courseCount && event.values[0] == (float)(int)event.values[0]))
+            validCourses = false;
+    }
+    if (!validCourses)
+    {
+        std::cerr << path << " utilise un parcours absent (" << courseCount << " parcours chargs)" << std::endl;
+        return false;
+    }
+
+    loaded = true;
+    return true;
+}
+
+void ReplayPlayer::rewind()
+{
+    nextEvent = 0;
+    accumulator = 0.0;
+    camera.valid = false;
+}
+
+bool ReplayPlayer::isLoaded() const
+{
+    return loaded;
+}
+
+bool ReplayPlayer::isFinished(const Physics& physics) const
+{
+    return nextEvent >= events.size() && physics.getStepCount() >= header.stepCount;
+}
+
+bool ReplayPlayer::applyDueEvents(Physics& physics, const CourseLibrary& courses, int& course)
+{
+    bool courseChanged = false;
+    while (nextEvent < events.size() && events[nextEvent].step <= physics.getStepCount())
+    {
+        const ReplayEvent& event = events[nextEvent++];
+        if (event.type == ReplayShot)
+        {
+            physics.applyImpulse(glm::vec3(event.values[0], event.values[1], event.values[2]));
+        }
+        else if (event.type == ReplayReset)
+        {
+            physics.reset();
+        }
+        else if (event.type == ReplayCourse)
+        {
+            course = (int)event.values[0];
+            physics.setCourse(courses, course);
+            courseChanged = true;
+        }
+        else if (event.type == ReplayCamera)
+        {
+            camera = ReplayCameraState{ event.values[0], event.values[1], event.values[2], true };
+        }
+    }
+    return courseChanged;
+}
+
+bool ReplayPlayer::step(Physics& physics, const CourseLibrary& courses, int& course, double deltaTime)
+{
+    PROFILE_CPU("physics");
+    bool courseChanged = false;
+    accumulator += deltaTime;
+
+    int steps = 0;
+    while (accumulator >= fixedTimeStep && steps < maxStepsPerUpdate && physics.getStepCount() < header.stepCount)
+    {
+        courseChanged |= applyDueEvents(physics, courses, course);
+        physics.fixedStep();
+        accumulator -= fixedTimeStep;
+        steps++;
+    }
+
+    if (steps == maxStepsPerUpdate && accumulator >= fixedTimeStep)
+    {
+        accumulator = 0.0;
+    }
+
+    if (physics.getStepCount() >= header.stepCount)
+        courseChanged |= applyDueEvents(physics, courses, course);
+
+    return courseChanged;
+}
+
+void ReplayPlayer::run(Physics& physics, const CourseLibrary& courses, int& course)
+{
+    while (physics.getStepCount() < header.stepCount)
+    {
+        applyDueEvents(physics, courses, course);
+        physics.fixedStep();
+    }
+    applyDueEvents(physics, courses, course);
+}
+
+bool ReplayPlayer::verify(const Physics& physics, int course) const
+{
+    const BallState& ball = physics.getBall();
+    bool same = course == header.finalCourse
+        && (physics.isInHole() ? 1u : 0u) == header.finalInHole
+        && std::memcmp(&ball, &header.finalBall, sizeof(BallState)) == 0;
+
+    if (!same)
+    {
+        std::cerr << "Divergence : parcours " << course << " au lieu de " << header.finalCourse
+                  << ", balle (" << ball.position.x << ", " << ball.position.y << ", " << ball.position.z
+                  << ") au lieu de (" << header.finalBall.position.x << ", " << header.finalBall.position.y << ", " << header.finalBall.position.z << ")" << std::endl;
+    }
+    return same;
+}
+
+const ReplayCameraState& ReplayPlayer::getCamera() const
+{
+    return camera;
+}
+
+uint32_t ReplayPlayer::getStepCount() const
+{
+    return header.stepCount;
+}
+
+uint32_t ReplayPlayer::getEventCount() const
+{
+    return header.eventCount;
+}
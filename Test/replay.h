@@ -0,0 +1,109 @@
+#pragma once
+#include "physics.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Enregistrement des entres d'une partie et relecture dterministe.
+// Chaque vnement est dat par le nombre de pas fixes simuls avant lui (Physics::getStepCount()) :
+// la relecture applique les mmes vnements entre les mmes pas et retrouve exactement le mme tat.
+// La camra est aussi enregistre (sans effet sur la simulation), pour revoir la partie comme le joueur.
+
+enum ReplayEventType
+{
+    ReplayShot,   // values : impulsion x, y, z, dure d'appui sur E (s)
+    ReplayReset,  // Touche R ou fin de parcours
+    ReplayCourse, // values[0] : indice du parcours charg
+    ReplayCamera  // values : angleX, angleY, zoom (au plus un par image, quand ils changent)
+};
+
+struct ReplayEvent
+{
+    uint32_t step;
+    uint32_t type; // ReplayEventType
+    float values[4];
+};
+
+// En-tte du fichier, suivi de ReplayEvent[eventCount]
+struct ReplayHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t eventCount;
+    uint32_t stepCount;  // Pas fixes simuls  la fin de l'enregistrement
+    int32_t finalCourse;
+    uint32_t finalInHole;
+    BallState finalBall; // tat attendu  la fin de la relecture
+};
+
+// Dernire camra relue
+struct ReplayCameraState
+{
+    float angleX;
+    float angleY;
+    float zoom;
+    bool valid; // false tant qu'aucun vnement camra n'a t appliqu
+};
+
+class ReplayRecorder
+{
+
+public:
+
+    ReplayRecorder();
+
+    void start(const char* path); // Les vnements ne sont gards qu'aprs start()
+    bool isRecording() const;
+
+    void recordShot(const Physics& physics, const glm::vec3& impulse, float pressDuration);
+    void recordReset(const Physics& physics);
+    void recordCourse(const Physics& physics, int course);
+    void recordCamera(const Physics& physics, float angleX, float angleY, float zoom);
+
+    bool save(const Physics& physics, int course) const; // crit le fichier avec l'tat final
+
+private:
+
+    std::string path;
+    bool recording;
+    std::vector<ReplayEvent> events;
+
+    void record(const Physics& physics, ReplayEventType type, float x, float y, float z, float w);
+};
+
+class ReplayPlayer
+{
+
+public:
+
+    ReplayPlayer();
+
+    bool load(const char* path, const CourseLibrary& courses); // Refuse un fichier tronqu ou qui cite un parcours absent de courses
+    void rewind(); // Reprend la relecture au dbut (avec un nouvel objet Physics)
+    bool isLoaded() const;
+    bool isFinished(const Physics& physics) const;
+
+    // Applique les vnements dus avant le prochain pas, retourne true si le parcours a chang
+    bool applyDueEvents(Physics& physics, const CourseLibrary& courses, int& course);
+
+    // Relecture au rythme de l'horloge (rendu), retourne true si le parcours a chang
+    bool step(Physics& physics, const CourseLibrary& courses, int& course, double deltaTime);
+
+    // Relecture aussi vite que possible jusqu' la fin de l'enregistrement
+    void run(Physics& physics, const CourseLibrary& courses, int& course);
+
+    bool verify(const Physics& physics, int course) const; // Compare  l'tat final enregistr (bit  bit)
+    const ReplayCameraState& getCamera() const;
+
+    uint32_t getStepCount() const;
+    uint32_t getEventCount() const;
+
+private:
+
+    ReplayHeader header;
+    std::vector<ReplayEvent> events;
+    size_t nextEvent;
+    double accumulator;
+    bool loaded;
+    ReplayCameraState camera;
+};
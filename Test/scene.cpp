@@ -0,0 +1,849 @@
+#include "scene.h"
+#include "gpu_profiler.h"
+#include "physics.h"
+#include <gtc/matrix_transform.hpp>
+#include <gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Objets OpenGL de la scne, librs par releaseScene()
+GlVertexArray sphereVAO;
+GlBuffer sphereVBO, sphereEBO;
+GlVertexArray courseVAO; // Sol et murs de tous les parcours, envoys une seule fois
+GlBuffer courseVBO, courseEBO;
+GlVertexArray cylinderVAO;
+GlBuffer cylinderVBO, cylinderEBO;
+GlVertexArray circleVAO;
+GlBuffer circleVBO;
+GlVertexArray powerGaugeVAO;
+GlBuffer powerGaugeVBO;
+glm::vec3 powerGaugeColor; // Couleur actuellement dans powerGaugeVBO
+GlVertexArray flagVAO;
+GlBuffer flagVBO;
+GlVertexArray trailVAO; // Maillage de la balle instanci, une instance par position de la trane
+GlBuffer trailVBO;
+GlProgram scenePrograms[sceneShaderCount]; // Dans l'ordre de sceneShaderSources
+GLuint shaderProgram, ballShaderProgram, circleShaderProgram, poleShaderProgram, flagShaderProgram, gaugeShaderProgram, trailShaderProgram, textShaderProgram; // Shaders
+StreamBuffer sceneStream; // Donnes refaites  chaque image : bloc Camera, texte, barres du profileur
+GLint uniformOffsetAlignment = 256; // Alignement des blocs uniformes dans sceneStream
+
+// Bloc uniforme Camera, disposition std140 (voir les vertex shaders)
+struct FrameConstants
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 screenProjection; // lments 2D (jauge), en pixels d'une fentre 800x600
+    glm::vec4 cameraPosition;
+};
+
+constexpr float circleRadius = 1.2f; // Trou
+constexpr float cylinderRadius = 0.1f; // Mt du drapeau
+constexpr float cylinderHeight = 7.0f;
+
+// Maillages calculs  la compilation, tous niveaux de dtail compris (voir procedural_mesh.h)
+constexpr SphereMeshData sphereMesh = buildSphereMesh<sphereMeshVertexCount, sphereMeshIndexCount>(ballRadius, sphereLodSectors, sphereLodStacks);
+constexpr CylinderMeshData cylinderMesh = buildCylinderMesh<cylinderMeshVertexCount, cylinderMeshIndexCount>(cylinderRadius, cylinderHeight, cylinderLodSegments);
+constexpr CircleMeshData circleMesh = buildCircleMesh<circleMeshVertexCount>(circleRadius, circleLodSegments);
+
+// Emplacements des uniformes, lus une fois aprs l'dition des liens
+GLint shaderModelLoc, ballModelLoc, circleModelLoc, flagModelLoc, gaugeModelLoc;
+GLint trailColorLoc, trailStartLoc, trailLengthLoc;
+
+// Trane : tampon circulaire de positions stock directement dans trailVBO ; chaque entre
+// garde aussi son emplacement (w) pour que le shader calcule le dgrad quelle que soit la
+// premire instance de la commande. L'limination et le niveau de dtail se font par morceaux
+// de trailChunkSize emplacements, chacun avec sa bote englobante tenue  jour  l'criture.
+struct TrailChunk
+{
+    glm::vec3 minimum; // Toutes les positions valides du morceau
+    glm::vec3 maximum;
+    glm::vec3 writtenMinimum; // Positions crites depuis que le tampon est revenu au dbut du morceau
+    glm::vec3 writtenMaximum;
+};
+
+const int trailChunkSize = 16;
+int trailLength = defaultTrailLength; // Capacit du tampon
+int trailHead = 0; // Prochain emplacement crit
+int trailCount = 0; // Nombre de positions valides
+std::vector<TrailChunk> trailChunks;
+const Course* sceneCourse = nullptr; // Parcours affich
+const CourseLibrary* sceneCourses = nullptr; // Parcours prsents dans courseVBO
+
+// Plage de dessin d'un parcours dans courseVBO/courseEBO : les quads du sol et des murs sont
+// dcoups en triangles par un motif d'indices commun, dcal par le sommet de base. Chaque quad
+// a une sphre englobante dans courseQuadBounds pour tre limin hors champ.
+struct CourseDrawRange
+{
+    GLint groundBaseVertex;
+    GLuint groundQuadCount;
+    GLint wallBaseVertex;
+    GLuint wallQuadCount;
+    uint32_t groundBoundsFirst; // Premier quad du sol dans courseQuadBounds
+    uint32_t wallBoundsFirst;
+};
+std::vector<CourseDrawRange> courseDrawRanges;
+std::vector<glm::vec4> courseQuadBounds; // Centre (xyz) et rayon (w)
+const CourseDrawRange* sceneDrawRange = nullptr;
+
+enum SceneMaterial
+{
+    NoMaterial,
+    TrailMaterial,
+    TextMaterial
+};
+RenderQueue renderQueue; // lments de l'image en cours, dessins par drawScene()
+const MeshLod* const sphereLods = sphereMesh.lods; // Balle et trane, du plus fin au plus grossier
+const MeshLod* const cylinderLods = cylinderMesh.lods;
+const MeshLod* const circleLods = circleMesh.lods;
+Frustum sceneFrustum; // Champ de la camra de l'image en cours
+FontAtlas hudFont; // Glyphes du HUD, une seule texture
+TextBatch hudText; // Chanes de l'image en cours
+
+#ifdef GOLF_PROFILE
+GlVertexArray profilerOverlayVAO; // Barres du profileur, rcrites dans sceneStream  chaque image
+const int overlayQuadsPerSection = 4;
+const int overlayVertexSize = 6; // Position et couleur, comme la jauge
+bool profilerOverlayVisible = false;
+#endif
+
+void setupSphere()
+{
+    // Le maillage prcdent est libr par ses poignes si la balle est rgnre.
+    // L'EBO reste attach au VAO : un seul glDrawElements suffit pour dessiner la balle
+    uploadMesh(sphereMesh, sphereVAO, sphereVBO, sphereEBO);
+
+    // La trane pointe sur les tampons de la balle : la rattacher au nouveau maillage
+    if (trailVBO)
+        setupTrailMesh();
+}
+
+void setupTrailMesh()
+{
+    trailVAO.create();
+    glBindVertexArray(trailVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
+    setMeshAttributes();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+
+    // Position de chaque sphre de la trane et son emplacement, lus une fois par instance
+    glBindBuffer(GL_ARRAY_BUFFER, trailVBO);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (GLvoid*)0);
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+}
+
+void setTrailLength(int length)
+{
+    trailLength = std::max(1, std::min(length, maxTrailLength));
+    trailHead = 0;
+    trailCount = 0;
+
+    if (!trailVBO)
+        trailVBO.create();
+    glBindBuffer(GL_ARRAY_BUFFER, trailVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * trailLength, nullptr, GL_DYNAMIC_DRAW);
+    trailVBO.setByteSize(sizeof(glm::vec4) * trailLength);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    trailChunks.assign((trailLength + trailChunkSize - 1) / trailChunkSize, TrailChunk());
+
+    setupTrailMesh();
+}
+
+int getTrailLength()
+{
+    return trailLength;
+}
+
+// Sphre englobante de chaque quad, calcule depuis ses quatre sommets
+static void appendQuadBounds(const float* vertices, uint32_t firstVertex, uint32_t quadCount)
+{
+    for (uint32_t quad = 0; quad < quadCount; ++quad)
+    {
+        glm::vec3 corners[4];
+        glm::vec3 center = glm::vec3(0.0f);
+        for (int i = 0; i < 4; ++i)
+        {
+            const float* vertex = vertices + (size_t)(firstVertex + quad * 4 + i) * courseVertexSize;
+            corners[i] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+            center += corners[i] * 0.25f;
+        }
+
+        float radius = 0.0f;
+        for (const glm::vec3& corner : corners)
+            radius = std::max(radius, glm::length(corner - center));
+        courseQuadBounds.push_back(glm::vec4(center, radius));
+    }
+}
+
+void setupCourseGeometry(const CourseLibrary& courses)
+{
+    courseDrawRanges.clear();
+    courseQuadBounds.clear();
+    uint32_t maxQuadCount = 0;
+    for (int i = 0; i < courses.getCourseCount(); ++i)
+    {
+        const Course& course = courses.getCourse(i);
+        CourseDrawRange range;
+        range.groundBaseVertex = (GLint)course.groundFirst;
+        range.groundQuadCount = course.groundCount / 4;
+        range.wallBaseVertex = (GLint)course.wallFirst;
+        range.wallQuadCount = course.wallCount / 4;
+        range.groundBoundsFirst = (uint32_t)courseQuadBounds.size();
+        appendQuadBounds(courses.getVertices(), course.groundFirst, range.groundQuadCount);
+        range.wallBoundsFirst = (uint32_t)courseQuadBounds.size();
+        appendQuadBounds(courses.getVertices(), course.wallFirst, range.wallQuadCount);
+        courseDrawRanges.push_back(range);
+        maxQuadCount = std::max(maxQuadCount, std::max(course.groundCount, course.wallCount) / 4);
+    }
+
+    courseVAO.create();
+    glBindVertexArray(courseVAO);
+
+    // Tous les sommets du cache en un seul tampon, directement depuis le fichier projet en mmoire
+    courseVBO.create();
+    glBindBuffer(GL_ARRAY_BUFFER, courseVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * courseVertexSize * courses.getVertexCount(), courses.getVertices(), GL_STATIC_DRAW);
+    courseVBO.setByteSize(sizeof(GLfloat) * courseVertexSize * courses.getVertexCount());
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+
+    // Deux triangles par quad, valables pour n'importe quelle suite de quads
+    std::vector<GLuint> quadIndices;
+    quadIndices.reserve(maxQuadCount * 6);
+    for (GLuint quad = 0; quad < maxQuadCount; ++quad)
+    {
+        GLuint first = quad * 4;
+        GLuint pattern[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+        quadIndices.insert(quadIndices.end(), pattern, pattern + 6);
+    }
+
+    courseEBO.create();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, courseEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * quadIndices.size(), quadIndices.data(), GL_STATIC_DRAW);
+    courseEBO.setByteSize(sizeof(GLuint) * quadIndices.size());
+
+    glBindVertexArray(0);
+
+    sceneCourses = &courses;
+}
+
+void setupCircle()
+{
+    // Un ventail de triangles par niveau de dtail,  la suite dans le mme tampon
+    uploadMesh(circleMesh, circleVAO, circleVBO);
+}
+
+void setupPowerGauge()
+{
+    powerGaugeVAO.create();
+    glBindVertexArray(powerGaugeVAO);
+
+    powerGaugeVBO.create();
+    glBindBuffer(GL_ARRAY_BUFFER, powerGaugeVBO);
+
+    // Dimensions ajustes pour l'indicateur de puissance (repositionn loin du bord droit)
+    GLfloat powerGaugeVertices[] =
+    {
+        // Positions                // Couleurs
+         600.0f, 550.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En bas  gauche
+         600.0f, 580.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En haut  gauche
+         750.0f, 580.0f, 0.0f,      1.0f, 1.0f, 1.0f,  // En haut  droite
+         750.0f, 550.0f, 0.0f,      1.0f, 1.0f, 1.0f   // En bas  droite
+    };
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(powerGaugeVertices), powerGaugeVertices, GL_DYNAMIC_DRAW);
+    powerGaugeVBO.setByteSize(sizeof(powerGaugeVertices));
+    powerGaugeColor = glm::vec3(1.0f);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+
+    glBindVertexArray(0);
+}
+
+void setupCylinder()
+{
+    uploadMesh(cylinderMesh, cylinderVAO, cylinderVBO, cylinderEBO);
+}
+
+void setupFlag()
+{
+    flagVAO.create();
+    glBindVertexArray(flagVAO);
+
+    flagVBO.create();
+    glBindBuffer(GL_ARRAY_BUFFER, flagVBO);
+
+    // Dfinir les sommets du drapeau (triangle rouge plus grand et align  gauche)
+    GLfloat flagVertices[] = {
+        // Positions                // Couleurs
+        0.0f, 7.0f, 0.0f,          1.0f, 0.0f, 0.0f,  // En bas  gauche
+        0.0f, 6.0f, 0.0f,          1.0f, 0.0f, 0.0f,  // En bas  droite
+        1.5f, 6.5f, 0.0f,          1.0f, 0.0f, 0.0f   // En haut
+    };
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(flagVertices), flagVertices, GL_STATIC_DRAW);
+    flagVBO.setByteSize(sizeof(flagVertices));
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+
+    glBindVertexArray(0);
+}
+
+void updatePowerGauge(float powerRatio, bool coolingDown)
+{
+    PROFILE_CPU("updatePowerGauge");
+    // Calculer la couleur en fonction du rapport de puissance
+    glm::vec3 color;
+    if (coolingDown)
+    {
+        color = glm::vec3(0.5f, 0.5f, 0.5f); // Couleur grise pendant le temps de rcupration
+    }
+    else
+    {
+        if (powerRatio < 0.25f)
+            color = glm::mix(glm::vec3(1.0f), glm::vec3(0.0f, 1.0f, 0.0f), powerRatio * 4.0f);  // Blanc  Vert
+        else if (powerRatio < 0.5f)
+            color = glm::mix(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f), (powerRatio - 0.25f) * 4.0f);  // Vert  Jaune
+        else if (powerRatio < 0.75f)
+            color = glm::mix(glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.5f, 0.0f), (powerRatio - 0.5f) * 4.0f);  // Jaune  Orange
+        else
+            color = glm::mix(glm::vec3(1.0f, 0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), (powerRatio - 0.75f) * 4.0f);  // Orange  Rouge
+    }
+
+    // La jauge ne change qu'en chargeant un tir ou au dbut et  la fin du temps de rcupration :
+    // le reste du temps, rien n'est envoy
+    if (color == powerGaugeColor)
+        return;
+    powerGaugeColor = color;
+
+    GLfloat powerGaugeVertices[] =
+    {
+        // Positions              // Couleurs
+         600.0f, 550.0f, 0.0f,     color.r, color.g, color.b,  // En bas  gauche
+         600.0f, 580.0f, 0.0f,     color.r, color.g, color.b,  // En haut  gauche
+         750.0f, 580.0f, 0.0f,     color.r, color.g, color.b,  // En haut  droite
+         750.0f, 550.0f, 0.0f,     color.r, color.g, color.b   // En bas  droite
+    };
+
+    glBindBuffer(GL_ARRAY_BUFFER, powerGaugeVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(powerGaugeVertices), powerGaugeVertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void drawPowerGauge()
+{
+    PROFILE_CPU("drawPowerGauge");
+    renderQueue.submitArrays(OverlayLayer, gaugeShaderProgram, powerGaugeVAO, gaugeModelLoc, glm::mat4(1.0f), GL_QUADS, 0, 4);
+}
+
+void drawSphere(const SceneView& scene)
+{
+    PROFILE_CPU("drawSphere");
+    if (!sceneFrustum.intersectsSphere(scene.ballPosition, ballRadius))
+        return;
+
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, scene.ballPosition) * scene.ballRotation; // Appliquer la rotation
+
+    const MeshLod& lod = sphereLods[selectLod(sphereLods, sphereLodCount, sceneFrustum.getProjectedRadius(scene.ballPosition, ballRadius))];
+    renderQueue.submitElements(SceneLayer, ballShaderProgram, sphereVAO, ballModelLoc, model, GL_TRIANGLES, lod.baseVertex, lod.firstIndex, lod.count);
+}
+
+// Quads visibles d'une plage du parcours ; les quads conscutifs forment un seul lment
+static void submitCourseQuads(GLint baseVertex, uint32_t boundsFirst, GLuint quadCount)
+{
+    GLuint runStart = 0;
+    for (GLuint quad = 0; quad <= quadCount; ++quad)
+    {
+        const glm::vec4& bounds = courseQuadBounds[boundsFirst + std::min(quad, quadCount - 1)];
+        if (quad < quadCount && sceneFrustum.intersectsSphere(glm::vec3(bounds), bounds.w))
+            continue;
+
+        if (quad > runStart)
+            renderQueue.submitElements(SceneLayer, shaderProgram, courseVAO, shaderModelLoc, glm::mat4(1.0f), GL_TRIANGLES, baseVertex, runStart * 6, (quad - runStart) * 6);
+        runStart = quad + 1;
+    }
+}
+
+// Le sol et les murs partagent programme, VAO et matrice : la file les dessine en un seul glMultiDrawElementsBaseVertex
+void drawGround()
+{
+    PROFILE_CPU("drawGround");
+    submitCourseQuads(sceneDrawRange->groundBaseVertex, sceneDrawRange->groundBoundsFirst, sceneDrawRange->groundQuadCount);
+}
+
+void drawWalls()
+{
+    PROFILE_CPU("drawWalls");
+    submitCourseQuads(sceneDrawRange->wallBaseVertex, sceneDrawRange->wallBoundsFirst, sceneDrawRange->wallQuadCount);
+}
+
+void drawCircle()
+{
+    PROFILE_CPU("drawCircle");
+    glm::vec3 holePosition = sceneCourse->holePosition + glm::vec3(0.0f, 0.02f, 0.0f); // Lgrement au-dessus du sol
+    if (!sceneFrustum.intersectsSphere(holePosition, circleRadius))
+        return;
+
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, holePosition);
+
+    const MeshLod& lod = circleLods[selectLod(circleLods, circleLodCount, sceneFrustum.getProjectedRadius(holePosition, circleRadius))];
+    renderQueue.submitArrays(SceneLayer, circleShaderProgram, circleVAO, circleModelLoc, model, GL_TRIANGLE_FAN, lod.baseVertex, lod.count);
+}
+
+void drawCylinder()
+{
+    PROFILE_CPU("drawCylinder");
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 cylinderPosition = sceneCourse->holePosition;
+    model = glm::translate(model, cylinderPosition);
+
+    // Le cylindre puis le drapeau, au mme endroit, chacun avec sa sphre englobante ; le dtail
+    // du mt dpend de son rayon  l'cran, vu depuis son milieu
+    glm::vec3 poleCenter = cylinderPosition + glm::vec3(0.0f, cylinderHeight / 2.0f, 0.0f);
+    if (sceneFrustum.intersectsSphere(poleCenter, cylinderHeight / 2.0f + cylinderRadius))
+    {
+        const MeshLod& lod = cylinderLods[selectLod(cylinderLods, cylinderLodCount, sceneFrustum.getProjectedRadius(poleCenter, cylinderRadius))];
+        renderQueue.submitElements(SceneLayer, shaderProgram, cylinderVAO, shaderModelLoc, model, GL_TRIANGLES, lod.baseVertex, lod.firstIndex, lod.count);
+    }
+
+    if (sceneFrustum.intersectsSphere(cylinderPosition + glm::vec3(0.75f, 6.5f, 0.0f), 0.9f))
+        renderQueue.submitArrays(SceneLayer, flagShaderProgram, flagVAO, flagModelLoc, model, GL_TRIANGLES, 0, 3);
+}
+
+// Uniformes de la trane, rgls par la file quand elle passe au matriau TrailMaterial
+static void setupTrailMaterial()
+{
+    glm::vec4 color = glm::vec4(0.0f, 1.0f, 1.0f, 1.0f); // Couleur cyan, le dgrad est calcul dans le shader
+    glUniform4fv(trailColorLoc, 1, glm::value_ptr(color));
+    glUniform1i(trailStartLoc, (trailHead - trailCount + trailLength) % trailLength); // Emplacement de la position la plus ancienne
+    glUniform1i(trailLengthLoc, trailLength);
+}
+
+// Chaque morceau de la trane est test contre le champ et reoit le niveau de dtail de sa plus
+// grande sphre vue au plus prs : le cot ne dpend que du nombre de morceaux. Les morceaux
+// voisins ont presque toujours le mme niveau, d'o une commande instancie par suite de morceaux
+// visibles de mme niveau. Sans GL_ARB_base_instance, une seule commande au niveau le plus fin ncessaire.
+void drawTrail()
+{
+    PROFILE_CPU("drawTrail");
+    if (trailCount == 0)
+        return;
+
+    int trailStart = (trailHead - trailCount + trailLength) % trailLength;
+    int chunkCount = (trailCount + trailChunkSize - 1) / trailChunkSize;
+    bool splitRuns = GLEW_ARB_base_instance != 0;
+    int finestLod = sphereLodCount;
+    int runStart = 0;
+    int runLod = -1;
+    for (int chunk = 0; chunk <= chunkCount; ++chunk)
+    {
+        // Les emplacements valides sont toujours 0..trailCount-1 (voir pushTrailPosition)
+        int first = chunk * trailChunkSize;
+        int lod = -1;
+        if (chunk < chunkCount)
+        {
+            // Plus grande sphre du morceau : celle qui prcde la plus ancienne si elle y est, sinon la dernire (comme le shader)
+            int last = std::min(first + trailChunkSize, trailCount) - 1;
+            int newest = trailStart > first && trailStart <= last ? trailStart - 1 : last;
+            float radius = ballRadius * 0.5f * ((newest - trailStart + trailLength) % trailLength) / trailLength;
+
+            const TrailChunk& bounds = trailChunks[chunk];
+            glm::vec3 center = (bounds.minimum + bounds.maximum) * 0.5f;
+            float spread = glm::length(bounds.maximum - center);
+            if (radius > 0.0f && sceneFrustum.intersectsSphere(center, spread + radius))
+                lod = selectLod(sphereLods, sphereLodCount, sceneFrustum.getProjectedRadius(center, spread, radius));
+        }
+        if (lod >= 0)
+            finestLod = std::min(finestLod, lod);
+
+        if (!splitRuns || lod == runLod)
+            continue;
+
+        if (runLod >= 0)
+        {
+            const MeshLod& range = sphereLods[runLod];
+            renderQueue.submitElements(SceneLayer, trailShaderProgram, trailVAO, -1, glm::mat4(1.0f), GL_TRIANGLES, range.baseVertex, range.firstIndex, range.count,
+                std::min(first, trailCount) - runStart, runStart, TrailMaterial);
+        }
+        runStart = first;
+        runLod = lod;
+    }
+
+    if (!splitRuns && finestLod < sphereLodCount)
+    {
+        const MeshLod& range = sphereLods[finestLod];
+        renderQueue.submitElements(SceneLayer, trailShaderProgram, trailVAO, -1, glm::mat4(1.0f), GL_TRIANGLES, range.baseVertex, range.firstIndex, range.count,
+            trailCount, 0, TrailMaterial);
+    }
+}
+
+// Texture de l'atlas et fusion pour l'opacit des glyphes ; sans test de profondeur, les glyphes
+// voisins qui se recouvrent ne se masquent pas
+static void setupTextMaterial()
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, hudFont.getTexture());
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+}
+
+static void cleanupTextMaterial()
+{
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void addHudText(const std::string& text, float x, float y, float scale, const glm::vec3& color)
+{
+    if (hudFont.isLoaded())
+        hudText.addText(hudFont, text, x, y, scale, color);
+}
+
+float getHudTextWidth(const std::string& text, float scale)
+{
+    return hudFont.measure(text, scale);
+}
+
+// Toutes les chanes de l'image en un seul tampon et une seule commande
+static void drawHudText()
+{
+    PROFILE_CPU("drawHudText");
+    if (hudText.isEmpty())
+        return;
+
+    GLint firstVertex = hudText.upload(sceneStream);
+    if (firstVertex >= 0)
+        renderQueue.submitArrays(OverlayLayer, textShaderProgram, hudText.getVAO(), -1, glm::mat4(1.0f), GL_TRIANGLES, firstVertex, hudText.getVertexCount(), TextMaterial);
+}
+
+// Camra orbitale autour de la balle, calcule une fois par image pour tous les objets
+void updateFrameConstants(const SceneView& scene)
+{
+    PROFILE_CPU("updateFrameConstants");
+    FrameConstants frame;
+    frame.projection = glm::perspective(glm::radians(45.0f), (float)scene.width / (float)scene.height, 0.1f, 100.0f);
+
+    glm::vec3 cameraPosition = scene.ballPosition + glm::vec3(
+        scene.zoom * cos(scene.angleX) * sin(scene.angleY),
+        scene.zoom * sin(scene.angleX) + 2.0f,
+        scene.zoom * cos(scene.angleX) * cos(scene.angleY)
+    );
+    frame.view = glm::lookAt(cameraPosition, scene.ballPosition, glm::vec3(0.0f, 1.0f, 0.0f));
+    frame.screenProjection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
+    frame.cameraPosition = glm::vec4(cameraPosition, 1.0f);
+    sceneFrustum.update(frame.projection * frame.view, cameraPosition, scene.height / (2.0f * tan(glm::radians(22.5f))));
+
+    // Nouvelle copie  chaque image dans le tampon de flux : pas d'attente des images en vol
+    StreamAllocation allocation = sceneStream.allocate(sizeof(FrameConstants), uniformOffsetAlignment);
+    if (!allocation.pointer)
+        return;
+    std::memcpy(allocation.pointer, &frame, sizeof(FrameConstants));
+    glBindBufferRange(GL_UNIFORM_BUFFER, cameraBlockBinding, sceneStream.getBuffer(), allocation.offset, sizeof(FrameConstants));
+}
+
+// Relie le bloc Camera du programme au tampon partag et renvoie l'emplacement de "model"
+static GLint bindSceneProgram(GLuint program)
+{
+    if (!program)
+        return -1;
+
+    GLuint blockIndex = glGetUniformBlockIndex(program, "Camera");
+    if (blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, blockIndex, cameraBlockBinding);
+
+    return glGetUniformLocation(program, "model");
+}
+
+const ShaderProgramSource sceneShaderSources[sceneShaderCount] =
+{
+    { "ball_vertex_shader.glsl", "ball_fragment_shader.glsl" },
+    { "vertex_shader.glsl", "fragment_shader.glsl" },
+    { "circle_vertex_shader.glsl", "circle_fragment_shader.glsl" },
+    { "pole_vertex_shader.glsl", "pole_fragment_shader.glsl" },
+    { "flag_vertex_shader.glsl", "flag_fragment_shader.glsl" },
+    { "gauge_vertex_shader.glsl", "gauge_fragment_shader.glsl" },
+    { "trail_vertex_shader.glsl", "trail_fragment_shader.glsl" },
+    { "text_vertex_shader.glsl", "text_fragment_shader.glsl" }
+};
+
+bool setupScene(const char* shaderCachePath)
+{
+    setupSphere();
+    setTrailLength(trailLength);
+    setupCylinder();
+    setupCircle();
+    setupPowerGauge();
+    setupFlag();
+
+    // Tous les programmes en un seul lot, relus depuis le cache quand c'est possible
+    GLuint programs[sceneShaderCount];
+    ShaderLoadStats stats;
+    if (!loadShaderPrograms(sceneShaderSources, sceneShaderCount, programs, shaderCachePath, &stats))
+        return false;
+    std::cout << "Shaders : " << sceneShaderCount << " programmes en " << stats.milliseconds << " ms ("
+        << stats.cacheHits << " depuis le cache, " << stats.compiled << " compils)" << std::endl;
+
+    for (int i = 0; i < sceneShaderCount; ++i)
+        scenePrograms[i].adopt(programs[i]);
+    ballShaderProgram = programs[0];
+    shaderProgram = programs[1];
+    circleShaderProgram = programs[2];
+    poleShaderProgram = programs[3];
+    flagShaderProgram = programs[4];
+    gaugeShaderProgram = programs[5];
+    trailShaderProgram = programs[6];
+    textShaderProgram = programs[7];
+
+    if (!sceneStream.setup(sceneStreamRegionSize))
+        return false;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformOffsetAlignment);
+
+    shaderModelLoc = bindSceneProgram(shaderProgram);
+    ballModelLoc = bindSceneProgram(ballShaderProgram);
+    circleModelLoc = bindSceneProgram(circleShaderProgram);
+    bindSceneProgram(poleShaderProgram);
+    flagModelLoc = bindSceneProgram(flagShaderProgram);
+    gaugeModelLoc = bindSceneProgram(gaugeShaderProgram);
+    bindSceneProgram(trailShaderProgram);
+    trailColorLoc = glGetUniformLocation(trailShaderProgram, "color");
+    trailStartLoc = glGetUniformLocation(trailShaderProgram, "trailStart");
+    trailLengthLoc = glGetUniformLocation(trailShaderProgram, "trailLength");
+    bindSceneProgram(textShaderProgram);
+    renderQueue.setMaterial(TrailMaterial, setupTrailMaterial);
+    renderQueue.setMaterial(TextMaterial, setupTextMaterial, cleanupTextMaterial);
+
+#ifdef GOLF_PROFILE
+    profilerOverlayVAO.create();
+    glBindVertexArray(profilerOverlayVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, sceneStream.getBuffer());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, overlayVertexSize * sizeof(GLfloat), (GLvoid*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, overlayVertexSize * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+
+    // Sans police, le jeu reste jouable : le HUD n'a simplement pas de texte
+    hudText.setup(sceneStream);
+    if (!hudFont.load(hudFontPath, hudFontSize))
+        std::cerr << "Texte du HUD dsactiv" << std::endl;
+    return true;
+}
+
+void releaseScene()
+{
+    sphereVAO.reset();
+    sphereVBO.reset();
+    sphereEBO.reset();
+    courseVAO.reset();
+    courseVBO.reset();
+    courseEBO.reset();
+    cylinderVAO.reset();
+    cylinderVBO.reset();
+    cylinderEBO.reset();
+    circleVAO.reset();
+    circleVBO.reset();
+    powerGaugeVAO.reset();
+    powerGaugeVBO.reset();
+    flagVAO.reset();
+    flagVBO.reset();
+    trailVAO.reset();
+    trailVBO.reset();
+    sceneStream.release();
+    for (GlProgram& program : scenePrograms)
+        program.reset();
+#ifdef GOLF_PROFILE
+    profilerOverlayVAO.reset();
+#endif
+    hudFont.release();
+    hudText.release();
+
+    sceneCourses = nullptr;
+    sceneCourse = nullptr;
+    sceneDrawRange = nullptr;
+}
+
+void loadSceneCourse(const CourseLibrary& courses, int course)
+{
+    // Gomtrie envoye une fois pour toutes : changer de parcours ne change que la plage dessine
+    if (sceneCourses != &courses)
+        setupCourseGeometry(courses);
+
+    sceneCourse = &courses.getCourse(course);
+    sceneDrawRange = &courseDrawRanges[course];
+    trailHead = 0; // Effacer la trane
+    trailCount = 0;
+}
+
+void pushTrailPosition(const glm::vec3& position)
+{
+    PROFILE_CPU("pushTrailPosition");
+    // craser l'emplacement le plus ancien : seule la nouvelle position est envoye au GPU
+    glm::vec4 entry = glm::vec4(position, (float)trailHead);
+    glBindBuffer(GL_ARRAY_BUFFER, trailVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * trailHead, sizeof(glm::vec4), glm::value_ptr(entry));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Tant que le morceau n'est pas entirement rcrit, sa bote garde aussi les anciennes positions
+    TrailChunk& chunk = trailChunks[trailHead / trailChunkSize];
+    if (trailHead % trailChunkSize == 0)
+    {
+        chunk.writtenMinimum = position;
+        chunk.writtenMaximum = position;
+        chunk.minimum = trailCount == trailLength ? glm::min(chunk.minimum, position) : position;
+        chunk.maximum = trailCount == trailLength ? glm::max(chunk.maximum, position) : position;
+    }
+    else
+    {
+        chunk.writtenMinimum = glm::min(chunk.writtenMinimum, position);
+        chunk.writtenMaximum = glm::max(chunk.writtenMaximum, position);
+        chunk.minimum = glm::min(chunk.minimum, position);
+        chunk.maximum = glm::max(chunk.maximum, position);
+    }
+    if (trailHead % trailChunkSize == trailChunkSize - 1 || trailHead == trailLength - 1)
+    {
+        chunk.minimum = chunk.writtenMinimum;
+        chunk.maximum = chunk.writtenMaximum;
+    }
+
+    trailHead = (trailHead + 1) % trailLength;
+    trailCount = std::min(trailCount + 1, trailLength);
+}
+
+#ifdef GOLF_PROFILE
+// Une ligne par section du profileur : barre de la moyenne (verte pour le CPU, bleue pour le
+// GPU, jaune pour l'image entire), trait rouge au p99, puis le nom et les valeurs en texte.
+// L'chelle fait deux images  60 images/s, avec un repre blanc  16,7 ms.
+// z dpartage les quads qui se recouvrent (un z plus grand passe devant avec la projection 2D)
+static void appendOverlayQuad(GLfloat*& vertices, float x0, float y0, float x1, float y1, float z, const glm::vec3& color)
+{
+    const float corners[6][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y0 }, { x1, y1 }, { x0, y1 } };
+    for (const float* corner : corners)
+    {
+        GLfloat vertex[overlayVertexSize] = { corner[0], corner[1], z, color.r, color.g, color.b };
+        std::memcpy(vertices, vertex, sizeof(vertex));
+        vertices += overlayVertexSize;
+    }
+}
+
+static void drawProfilerOverlay()
+{
+    PROFILE_CPU("drawProfilerOverlay");
+    const float left = 10.0f;
+    const float top = 590.0f;
+    const float rowHeight = 8.0f;
+    const float rowSpacing = 3.0f;
+    const float scaleWidth = 300.0f;
+    const float scaleMilliseconds = 1000.0f / 30.0f;
+
+    // Les sommets sont crits directement dans la rgion de l'image du tampon de flux
+    int sectionCount = profiler.getSectionCount();
+    GLsizei vertexCount = sectionCount * overlayQuadsPerSection * 6;
+    StreamAllocation allocation = sceneStream.allocate(sizeof(GLfloat) * overlayVertexSize * vertexCount, sizeof(GLfloat) * overlayVertexSize);
+    if (!allocation.pointer)
+        return;
+    GLfloat* vertices = static_cast<GLfloat*>(allocation.pointer);
+    for (int i = 0; i < sectionCount; ++i)
+    {
+        float y1 = top - i * (rowHeight + rowSpacing);
+        float y0 = y1 - rowHeight;
+        float averageMilliseconds = profiler.getAverage(i);
+        float p99Milliseconds = profiler.getPercentile(i, 0.99f);
+        float average = std::min(averageMilliseconds / scaleMilliseconds, 1.0f) * scaleWidth;
+        float p99 = std::min(p99Milliseconds / scaleMilliseconds, 1.0f) * scaleWidth;
+
+        glm::vec3 color = profiler.isGpuSection(i) ? glm::vec3(0.2f, 0.5f, 1.0f) : glm::vec3(0.2f, 0.8f, 0.2f);
+        if (i == 0)
+            color = glm::vec3(1.0f, 0.8f, 0.1f); // Section "frame"
+
+        appendOverlayQuad(vertices, left, y0, left + scaleWidth, y1, 0.0f, glm::vec3(0.1f));
+        appendOverlayQuad(vertices, left + scaleWidth / 2.0f, y0, left + scaleWidth / 2.0f + 1.0f, y1, 0.1f, glm::vec3(1.0f));
+        appendOverlayQuad(vertices, left, y0, left + std::max(average, 1.0f), y1, 0.2f, color);
+        appendOverlayQuad(vertices, left + p99 - 1.0f, y0 - 1.0f, left + p99 + 1.0f, y1 + 1.0f, 0.3f, glm::vec3(1.0f, 0.0f, 0.0f));
+
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s%s  %.2f / %.2f ms", profiler.getSectionName(i), profiler.isGpuSection(i) ? " (GPU)" : "",
+            averageMilliseconds, p99Milliseconds);
+        addHudText(label, left + scaleWidth + 6.0f, y0, 0.28f, glm::vec3(1.0f));
+    }
+
+    GLint firstVertex = (GLint)(allocation.offset / (sizeof(GLfloat) * overlayVertexSize));
+    renderQueue.submitArrays(OverlayLayer, gaugeShaderProgram, profilerOverlayVAO, gaugeModelLoc, glm::mat4(1.0f), GL_TRIANGLES, firstVertex, vertexCount);
+}
+
+void setProfilerOverlay(bool visible)
+{
+    profilerOverlayVisible = visible;
+}
+
+bool isProfilerOverlayVisible()
+{
+    return profilerOverlayVisible;
+}
+#endif
+
+void drawScene(const SceneView& scene)
+{
+    // Effacement hors de la mesure GPU : llvmpipe ne date le dbut d'une requte GL_TIME_ELAPSED que
+    // si le framebuffer a dj t valid par une commande de dessin. Sinon la premire image
+    // renvoie l'horloge GPU absolue au lieu d'une dure
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    PROFILE_GPU("drawScene");
+
+    // Les draw*() ne font que remplir la file, trie et dessine par flush() ; les donnes de
+    // l'image vont dans la rgion suivante du tampon de flux
+    sceneStream.beginFrame();
+    updateFrameConstants(scene);
+    drawGround();
+    drawWalls();
+    drawTrail();
+    drawCircle();
+    drawCylinder();
+    drawSphere(scene);
+    drawPowerGauge();
+#ifdef GOLF_PROFILE
+    if (profilerOverlayVisible)
+        drawProfilerOverlay();
+#endif
+    drawHudText();
+
+    sceneStream.commit();
+    PROFILE_CPU("renderQueue.flush");
+    renderQueue.flush();
+    sceneStream.endFrame();
+    hudText.clear();
+}
+
+const RenderStats& getRenderStats()
+{
+    return renderQueue.getStats();
+}
+
+const StreamBuffer& getSceneStream()
+{
+    return sceneStream;
+}
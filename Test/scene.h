@@ -0,0 +1,61 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm.hpp>
+#include "course.h"
+#include "frustum.h"
+#include "procedural_mesh.h"
+#include "render_queue.h"
+#include "shader_cache.h"
+#include "stream_buffer.h"
+#include "text_renderer.h"
+#include <string>
+
+// Rendu de la scne (parcours, balle, trane, trou, jauge), indpendant de la fentre :
+// il suffit d'un contexte OpenGL courant, cr par GLFW dans le jeu ou par EGL dans les outils.
+
+// Ce que le rendu doit savoir de la partie pour dessiner une image
+struct SceneView
+{
+    int width;          // Taille du framebuffer
+    int height;
+    float angleX;       // Camra orbitale autour de la balle
+    float angleY;
+    float zoom;
+    glm::vec3 ballPosition;
+    glm::mat4 ballRotation;
+};
+
+const int defaultTrailLength = 50; // Longueur de la trane par dfaut
+const int maxTrailLength = 16384; // Limite de setTrailLength()
+const GLuint cameraBlockBinding = 0; // Point de liaison du bloc uniforme Camera
+const GLsizeiptr sceneStreamRegionSize = 256 * 1024; // Donnes d'une image dans le tampon de flux
+
+const char* const hudFontPath = "fonts/arial.ttf";
+const int hudFontSize = 32; // Taille de rastrisation de l'atlas, en pixels
+
+const int sceneShaderCount = 8;
+extern const ShaderProgramSource sceneShaderSources[sceneShaderCount]; // Programmes de la scne
+
+bool setupScene(const char* shaderCachePath = defaultShaderCachePath); // Maillages fixes et shaders, une fois le contexte cr
+void releaseScene(); // Supprime tous les objets OpenGL de la scne, avant de dtruire le contexte
+void setupCourseGeometry(const CourseLibrary& courses); // Sol et murs de tous les parcours,  refaire si les parcours sont rechargs
+void loadSceneCourse(const CourseLibrary& courses, int course); // Choisit le parcours affich, efface la trane
+void setupSphere();
+void setupTrailMesh();
+void setTrailLength(int length); // Ralloue le tampon circulaire et efface la trane
+int getTrailLength();
+
+void updatePowerGauge(float powerRatio, bool coolingDown);
+void pushTrailPosition(const glm::vec3& position);
+// Texte de l'image en cours, dans le repre de la jauge (800x600) ; toutes les chanes sont
+// dessines par le prochain drawScene() en une seule commande
+void addHudText(const std::string& text, float x, float y, float scale, const glm::vec3& color);
+float getHudTextWidth(const std::string& text, float scale);
+void drawScene(const SceneView& scene);
+const RenderStats& getRenderStats(); // Commandes et changements d'tat de la dernire image
+const StreamBuffer& getSceneStream(); // Tampon de flux des donnes de chaque image
+
+#ifdef GOLF_PROFILE
+void setProfilerOverlay(bool visible); // Barres du profileur par-dessus la scne (F3 dans le jeu)
+bool isProfilerOverlayVisible();
+#endif
@@ -0,0 +1,355 @@
+#include "shader_cache.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Fichier de cache : en-tte, puis pour chaque programme une entre suivie du binaire
+struct ShaderCacheHeader
+{
+    char magic[4];          // "GSHD"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct ShaderCacheEntry
+{
+    uint64_t key;           // Empreinte des sources et du pilote
+    uint32_t format;        // Format renvoy par glGetProgramBinary
+    uint32_t size;
+};
+
+struct CachedProgram
+{
+    uint64_t key;
+    GLenum format;
+    std::vector<char> binary;
+};
+
+const char shaderCacheMagic[4] = { 'G', 'S', 'H', 'D' };
+const uint32_t shaderCacheVersion = 1;
+
+// Programme en cours de construction
+struct PendingProgram
+{
+    std::string vertexCode;
+    std::string fragmentCode;
+    uint64_t key;
+    GLuint vertexShader;
+    GLuint fragmentShader;
+    bool fromCache;
+};
+
+static bool readShaderFile(const char* path, std::string& code)
+{
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+        std::cerr << "Impossible d'ouvrir " << path << ". tes-vous dans le bon rpertoire ?" << std::endl;
+        return false;
+    }
+
+    std::stringstream sstr;
+    sstr << stream.rdbuf();
+    code = sstr.str();
+    return true;
+}
+
+static void mixHash(uint64_t& hash, const void* bytes, size_t size)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ull; // FNV-1a
+    }
+}
+
+static void mixHash(uint64_t& hash, const std::string& text)
+{
+    uint64_t size = text.size();
+    mixHash(hash, &size, sizeof(size));
+    mixHash(hash, text.data(), text.size());
+}
+
+// Un binaire n'est valable que pour le pilote qui l'a produit
+static uint64_t computeDriverKey()
+{
+    uint64_t hash = 14695981039346656037ull;
+    mixHash(hash, &shaderCacheVersion, sizeof(shaderCacheVersion));
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (GLenum name : names)
+    {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        mixHash(hash, value ? std::string(value) : std::string());
+    }
+    return hash;
+}
+
+static bool readShaderCache(const char* cachePath, std::vector<CachedProgram>& programs)
+{
+    std::ifstream cache(cachePath, std::ios::in | std::ios::binary);
+    if (!cache.is_open())
+        return false;
+
+    ShaderCacheHeader header;
+    if (!cache.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, shaderCacheMagic, sizeof(header.magic)) != 0 || header.version != shaderCacheVersion)
+        return false;
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        ShaderCacheEntry entry;
+        if (!cache.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+            return false;
+
+        CachedProgram program;
+        program.key = entry.key;
+        program.format = entry.format;
+        program.binary.resize(entry.size);
+        if (!cache.read(program.binary.data(), entry.size))
+            return false;
+        programs.push_back(std::move(program));
+    }
+    return true;
+}
+
+static bool writeShaderCache(const char* cachePath, const std::vector<CachedProgram>& programs)
+{
+    std::ofstream cache(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!cache.is_open())
+    {
+        std::cerr << "Impossible d'crire " << cachePath << std::endl;
+        return false;
+    }
+
+    ShaderCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, shaderCacheMagic, sizeof(header.magic));
+    header.version = shaderCacheVersion;
+    header.entryCount = (uint32_t)programs.size();
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const CachedProgram& program : programs)
+    {
+        ShaderCacheEntry entry;
+        entry.key = program.key;
+        entry.format = program.format;
+        entry.size = (uint32_t)program.binary.size();
+        cache.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        cache.write(program.binary.data(), program.binary.size());
+    }
+    return cache.good();
+}
+
+static bool checkShader(GLuint shader, const char* path)
+{
+    GLint result = GL_FALSE;
+    int infoLogLength;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+    if (infoLogLength > 0)
+    {
+        std::vector<char> errorMessage(infoLogLength + 1);
+        glGetShaderInfoLog(shader, infoLogLength, NULL, &errorMessage[0]);
+        std::cerr << path << " : " << &errorMessage[0] << std::endl;
+    }
+    return result == GL_TRUE;
+}
+
+static bool checkProgram(GLuint program)
+{
+    GLint result = GL_FALSE;
+    int infoLogLength;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+    if (infoLogLength > 0)
+    {
+        std::vector<char> errorMessage(infoLogLength + 1);
+        glGetProgramInfoLog(program, infoLogLength, NULL, &errorMessage[0]);
+        std::cerr << &errorMessage[0] << std::endl;
+    }
+    return result == GL_TRUE;
+}
+
+bool loadShaderPrograms(const ShaderProgramSource* sources, int count, GLuint* programs, const char* cachePath, ShaderLoadStats* stats)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    if (stats)
+        *stats = ShaderLoadStats();
+
+    std::vector<PendingProgram> pending(count);
+    bool success = true;
+    for (int i = 0; i < count; ++i)
+    {
+        programs[i] = 0;
+        pending[i].fromCache = false;
+        success &= readShaderFile(sources[i].vertexPath, pending[i].vertexCode);
+        success &= readShaderFile(sources[i].fragmentPath, pending[i].fragmentCode);
+    }
+    if (!success)
+        return false;
+
+    // Pas de format binaire (cache du pilote dsactiv, par exemple) : on compile toujours
+    GLint binaryFormatCount = 0;
+    if (cachePath && GLEW_ARB_get_program_binary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+    bool useCache = binaryFormatCount > 0;
+
+    std::vector<CachedProgram> cached;
+    if (useCache)
+    {
+        readShaderCache(cachePath, cached);
+
+        uint64_t driverKey = computeDriverKey();
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t hash = driverKey;
+            mixHash(hash, pending[i].vertexCode);
+            mixHash(hash, pending[i].fragmentCode);
+            pending[i].key = hash;
+        }
+    }
+
+    // Programmes dj lis lors d'un dmarrage prcdent
+    int cacheHits = 0;
+    for (int i = 0; i < count && useCache; ++i)
+    {
+        for (const CachedProgram& entry : cached)
+        {
+            if (entry.key != pending[i].key)
+                continue;
+
+            GLuint program = glCreateProgram();
+            glProgramBinary(program, entry.format, entry.binary.data(), (GLsizei)entry.binary.size());
+
+            GLint result = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &result);
+            if (result == GL_TRUE)
+            {
+                programs[i] = program;
+                pending[i].fromCache = true;
+                ++cacheHits;
+            }
+            else
+            {
+                glDeleteProgram(program); // Refus par le pilote : recompiler
+            }
+            break;
+        }
+    }
+
+    // Les autres sont compils puis lis d'un seul tenant ; les statuts ne sont lus qu' la fin,
+    // ce qui laisse les threads de compilation du pilote avancer (GL_KHR_parallel_shader_compile)
+    if (cacheHits < count)
+    {
+        if (GLEW_KHR_parallel_shader_compile)
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        else if (GLEW_ARB_parallel_shader_compile)
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (pending[i].fromCache)
+            continue;
+
+        std::cout << "Compilation du shader: " << sources[i].vertexPath << std::endl;
+        pending[i].vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        char const* vertexSourcePointer = pending[i].vertexCode.c_str();
+        glShaderSource(pending[i].vertexShader, 1, &vertexSourcePointer, NULL);
+        glCompileShader(pending[i].vertexShader);
+
+        std::cout << "Compilation du shader: " << sources[i].fragmentPath << std::endl;
+        pending[i].fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+        char const* fragmentSourcePointer = pending[i].fragmentCode.c_str();
+        glShaderSource(pending[i].fragmentShader, 1, &fragmentSourcePointer, NULL);
+        glCompileShader(pending[i].fragmentShader);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (pending[i].fromCache)
+            continue;
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, pending[i].vertexShader);
+        glAttachShader(program, pending[i].fragmentShader);
+        if (useCache)
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+        programs[i] = program;
+    }
+
+    int compiled = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (pending[i].fromCache)
+            continue;
+
+        GLuint program = programs[i];
+        bool linked = checkShader(pending[i].vertexShader, sources[i].vertexPath);
+        linked &= checkShader(pending[i].fragmentShader, sources[i].fragmentPath);
+        linked &= checkProgram(program);
+
+        glDetachShader(program, pending[i].vertexShader);
+        glDetachShader(program, pending[i].fragmentShader);
+        glDeleteShader(pending[i].vertexShader);
+        glDeleteShader(pending[i].fragmentShader);
+
+        if (linked)
+        {
+            ++compiled;
+        }
+        else
+        {
+            glDeleteProgram(program);
+            programs[i] = 0;
+            success = false;
+        }
+    }
+
+    // Rcrire le cache avec les programmes de ce lot (les entres primes disparaissent)
+    if (useCache && compiled > 0)
+    {
+        std::vector<CachedProgram> entries;
+        for (int i = 0; i < count; ++i)
+        {
+            if (!programs[i])
+                continue;
+
+            CachedProgram entry;
+            entry.key = pending[i].key;
+            GLint length = 0;
+            glGetProgramiv(programs[i], GL_PROGRAM_BINARY_LENGTH, &length);
+            entry.binary.resize(length);
+            GLsizei written = 0;
+            glGetProgramBinary(programs[i], length, &written, &entry.format, entry.binary.data());
+            entry.binary.resize(written);
+            if (written > 0)
+                entries.push_back(std::move(entry));
+        }
+        writeShaderCache(cachePath, entries);
+    }
+
+    if (stats)
+    {
+        stats->cacheHits = cacheHits;
+        stats->compiled = compiled;
+        stats->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    return success;
+}
+
+GLuint loadShaders(const char* vertex_file_path, const char* fragment_file_path)
+{
+    ShaderProgramSource source = { vertex_file_path, fragment_file_path };
+    GLuint program = 0;
+    loadShaderPrograms(&source, 1, &program, nullptr);
+    return program;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <GL/glew.h>
+
+// Construction des programmes de shaders. Tous les shaders d'un lot sont compils puis lis
+// avant de lire le moindre statut, pour laisser le pilote travailler en parallle, et les
+// programmes lis sont gards sur disque (glGetProgramBinary) pour les dmarrages suivants.
+
+// Un programme : un vertex shader et un fragment shader
+struct ShaderProgramSource
+{
+    const char* vertexPath;
+    const char* fragmentPath;
+};
+
+struct ShaderLoadStats
+{
+    int cacheHits;          // Programmes relus depuis le cache
+    int compiled;           // Programmes compils depuis les sources
+    double milliseconds;    // Dure totale, lecture des fichiers comprise
+};
+
+const char* const defaultShaderCachePath = "shaders.bin";
+
+// Construit count programmes dans programs (0 pour un programme en chec). Le cache est index
+// par le contenu des sources et le pilote (GL_VENDOR, GL_RENDERER, GL_VERSION) ; il est rcrit
+// ds qu'un programme a d tre compil. cachePath peut tre nul pour toujours compiler.
+bool loadShaderPrograms(const ShaderProgramSource* sources, int count, GLuint* programs, const char* cachePath, ShaderLoadStats* stats = nullptr);
+
+GLuint loadShaders(const char* vertex_file_path, const char* fragment_file_path); // Un seul programme, sans cache
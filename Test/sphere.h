@@ -1,5 +1,6 @@
 #pragma once
 #include <GL/glew.h>
+#include "gl_resource.h"
 
 class Sphere 
 {
@@ -7,22 +8,20 @@ class Sphere
 public:
 
     Sphere();
-    ~Sphere();
 
-    Sphere& operator=(const Sphere& other);
+    // Dplaable seulement : les objets OpenGL n'ont qu'un propritaire
+    Sphere(Sphere&& other) = default;
+    Sphere& operator=(Sphere&& other) = default;
 
     void draw();
 
 private:
 
-    GLuint vao;
-    GLuint vbo;
-
-    const int sectorCount = 36;
-    const int stackCount = 18;
-    const float radius = 1.0f;
+    GlVertexArray vao;
+    GlBuffer vbo;
+    GlBuffer ebo;
+    GLsizei indexCount;
 
     void setupMesh();
-    void copyMesh(const Sphere& other); // Fonction pour copier les donnes du maillage
 };
 
@@ -0,0 +1,156 @@
+#include "stream_buffer.h"
+#include <iostream>
+
+StreamBuffer::StreamBuffer()
+    : regionSize(0), persistent(false), mapped(nullptr), region(0), used(0), writing(false), stallCount(0)
+{
+    for (GLsync& fence : fences)
+        fence = nullptr;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    release();
+}
+
+bool StreamBuffer::setup(GLsizeiptr size, bool allowPersistent)
+{
+    release();
+    regionSize = size;
+    persistent = allowPersistent && GLEW_ARB_buffer_storage;
+
+    buffer.create();
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    if (persistent)
+    {
+        // Cohrent : les critures sont visibles du GPU sans glFlushMappedBufferRange
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, regionSize * streamFrameCount, nullptr, flags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * streamFrameCount, flags));
+        buffer.setByteSize(regionSize * streamFrameCount);
+    }
+    else
+    {
+        // Une seule rgion : le pilote donne une nouvelle zone  chaque orphelinage
+        glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+        buffer.setByteSize(regionSize);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (persistent && !mapped)
+    {
+        std::cerr << "Projection persistante du tampon de flux impossible" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void StreamBuffer::release()
+{
+    for (GLsync& fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    if (buffer && mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    mapped = nullptr;
+    writing = false;
+    buffer.reset();
+}
+
+void StreamBuffer::beginFrame()
+{
+    if (!buffer)
+        return;
+
+    used = 0;
+    if (persistent)
+    {
+        region = (region + 1) % streamFrameCount;
+
+        // La rgion a t lue il y a streamFrameCount images : la barrire est presque toujours passe
+        GLsync& fence = fences[region];
+        if (fence)
+        {
+            GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                ++stallCount;
+                do
+                {
+                    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                } while (status == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    else
+    {
+        // Orphelinage : l'ancienne zone reste au GPU jusqu' la fin de ses lectures
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    writing = mapped != nullptr;
+}
+
+StreamAllocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+    StreamAllocation allocation = { nullptr, 0 };
+    if (!writing)
+        return allocation;
+
+    GLintptr regionStart = persistent ? regionSize * region : 0;
+    GLintptr offset = (regionStart + used + alignment - 1) / alignment * alignment;
+    if (offset + size > regionStart + regionSize)
+        return allocation;
+
+    used = offset + size - regionStart;
+    allocation.pointer = (persistent ? mapped : mapped - regionStart) + offset;
+    allocation.offset = offset;
+    return allocation;
+}
+
+void StreamBuffer::commit()
+{
+    if (writing && !persistent)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mapped = nullptr;
+    }
+    writing = false;
+}
+
+void StreamBuffer::endFrame()
+{
+    if (persistent && buffer)
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLuint StreamBuffer::getBuffer() const
+{
+    return buffer;
+}
+
+bool StreamBuffer::isPersistent() const
+{
+    return persistent;
+}
+
+int StreamBuffer::getStallCount() const
+{
+    return stallCount;
+}
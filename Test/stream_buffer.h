@@ -0,0 +1,59 @@
+#pragma once
+#include <GL/glew.h>
+#include "gl_resource.h"
+
+// Tampon de flux pour les donnes refaites  chaque image (constantes de la camra, texte,
+// barres du profileur). Un seul grand tampon dcoup en streamFrameCount rgions : l'image en
+// cours crit directement dans la sienne pendant que le GPU lit encore les prcdentes, et une
+// barrire (fence) par rgion garantit qu'elle n'est rcrite qu'une fois ces lectures finies.
+// Avec GL_ARB_buffer_storage, le tampon est projet une seule fois pour toute sa dure de vie
+// (GL_MAP_PERSISTENT_BIT) ; sinon chaque image orpheline le tampon et projette la nouvelle zone.
+//
+//     stream.beginFrame();
+//     StreamAllocation allocation = stream.allocate(sizeof(data), alignment);
+//     if (allocation.pointer)
+//         memcpy(allocation.pointer, &data, sizeof(data)); // puis dessiner depuis allocation.offset
+//     stream.commit();        // Avant les commandes qui lisent le tampon
+//     ...
+//     stream.endFrame();      // Aprs ces commandes
+
+const int streamFrameCount = 3; // Rgion crite et deux images encore en vol
+
+struct StreamAllocation
+{
+    void* pointer;      // O crire ; nullptr si la rgion de l'image est pleine
+    GLintptr offset;    // Position dans le tampon (glBindBufferRange, premier sommet)
+};
+
+class StreamBuffer
+{
+
+public:
+
+    StreamBuffer();
+    ~StreamBuffer();
+
+    bool setup(GLsizeiptr regionSize, bool allowPersistent = true);
+    void release();
+
+    void beginFrame();
+    StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+    void commit();
+    void endFrame();
+
+    GLuint getBuffer() const;
+    bool isPersistent() const;
+    int getStallCount() const; // Nombre de fois o beginFrame() a attendu le GPU
+
+private:
+
+    GlBuffer buffer;
+    GLsizeiptr regionSize;
+    bool persistent;
+    unsigned char* mapped;      // Tout le tampon (persistant) ou la rgion de l'image (sinon)
+    int region;
+    GLsizeiptr used;            // Octets allous dans la rgion de l'image
+    bool writing;               // Entre beginFrame() et commit()
+    GLsync fences[streamFrameCount];
+    int stallCount;
+};
@@ -0,0 +1,70 @@
+#include "golf_test.h"
+#include "ball_batch.h"
+#include <cstring>
+#include <vector>
+
+// Chaque noyau disponible donne, balle par balle et bit  bit, le rsultat de Physics en collision discrte
+GOLF_TEST(batchMatchesPhysics)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    const BallBatchKernel kernels[] = { BallBatchScalar, BallBatchSse2, BallBatchAvx2 };
+    for (BallBatchKernel kernel : kernels)
+    {
+        if (!BallBatch::isKernelAvailable(kernel))
+        {
+            std::cout << "Noyau " << BallBatch::getKernelName(kernel) << " indisponible" << std::endl;
+            continue;
+        }
+
+        for (int index = 0; index < courses.getCourseCount(); ++index)
+        {
+            // Assez de tirs pour des blocs complets, un bloc partiel et des balles qui s'endorment  des pas diffrents
+            BallBatch batch;
+            batch.setKernel(kernel);
+            CHECK(batch.getKernel() == kernel);
+            batch.setCourse(courses, index);
+
+            std::vector<Physics> balls;
+            for (int angle = 0; angle < 30; ++angle)
+            {
+                for (int power = 1; power <= 3; ++power)
+                {
+                    glm::vec3 impulse = getShotDirection(0.0f, angle * 6.2831853f / 30.0f) * (maxImpulseStrength * power / 3.0f);
+                    batch.applyImpulse(batch.addBall(), impulse);
+
+                    Physics physics;
+                    physics.setCourse(courses, index);
+                    physics.setCollisionMode(DiscreteCollision);
+                    physics.applyImpulse(impulse);
+                    balls.push_back(physics);
+                }
+            }
+
+            for (int step = 0; step < 60 * 60; ++step)
+            {
+                batch.fixedStep();
+                for (Physics& physics : balls)
+                    physics.fixedStep();
+            }
+
+            int mismatches = 0;
+            for (int i = 0; i < batch.size(); ++i)
+            {
+                glm::vec3 position = batch.getPosition(i);
+                glm::vec3 velocity = batch.getVelocity(i);
+                const BallState& ball = balls[i].getBall();
+                bool same = std::memcmp(&position, &ball.position, sizeof(glm::vec3)) == 0
+                    && std::memcmp(&velocity, &ball.velocity, sizeof(glm::vec3)) == 0
+                    && batch.isInHole(i) == balls[i].isInHole()
+                    && batch.isAsleep(i) == balls[i].isAsleep()
+                    && batch.getWallContacts(i) == balls[i].getWallContacts();
+                mismatches += same ? 0 : 1;
+            }
+            CHECK(mismatches == 0);
+            if (mismatches > 0)
+                std::cerr << "Noyau " << BallBatch::getKernelName(kernel) << ", parcours " << index << " : " << mismatches << " balles diffrentes" << std::endl;
+        }
+    }
+}
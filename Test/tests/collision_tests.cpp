@@ -0,0 +1,176 @@
+#include "golf_test.h"
+#include "collision.h"
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+
+static bool isClose(float value, float expected)
+{
+    return std::abs(value - expected) < 1e-5f;
+}
+
+GOLF_TEST(collisionWallBounce)
+{
+    WallSegment wall = { glm::vec2(-10.0f, 0.0f), glm::vec2(10.0f, 0.0f) };
+
+    // Balle qui entre dans le mur : replace  un rayon, vitesse normale rflchie et amortie
+    glm::vec3 position(2.0f, ballRadius, 0.4f);
+    glm::vec3 velocity(0.05f, 0.0f, -0.1f);
+    CHECK(collideWall(wall, position, velocity));
+    CHECK(isClose(position.x, 2.0f) && isClose(position.z, ballRadius));
+    CHECK(isClose(velocity.x, 0.05f) && isClose(velocity.z, 0.1f * dampingFactor));
+
+    // Balle qui s'loigne : replace, sans rebond
+    position = glm::vec3(2.0f, ballRadius, 0.4f);
+    velocity = glm::vec3(0.0f, 0.0f, 0.1f);
+    CHECK(!collideWall(wall, position, velocity));
+    CHECK(isClose(position.z, ballRadius) && velocity.z == 0.1f);
+
+    // Hors de porte : rien ne change
+    position = glm::vec3(2.0f, ballRadius, 1.0f);
+    velocity = glm::vec3(0.0f, 0.0f, -0.1f);
+    CHECK(!collideWall(wall, position, velocity));
+    CHECK(position.z == 1.0f && velocity.z == -0.1f);
+
+    // Contre l'extrmit : normale du coin vers la balle
+    position = glm::vec3(10.3f, ballRadius, 0.4f);
+    velocity = glm::vec3(-0.1f, 0.0f, 0.0f);
+    CHECK(collideWall(wall, position, velocity));
+    CHECK(isClose(glm::length(glm::vec2(position.x, position.z) - wall.end), ballRadius));
+    CHECK(velocity.x > -0.1f);
+}
+
+// Grille d'une seule case qui liste tous les murs
+static WallSet makeWallSet(const WallSegment* segments, const uint32_t* cellStarts, const uint32_t* cellItems)
+{
+    WallSet walls;
+    walls.segments = segments;
+    walls.cellStarts = cellStarts;
+    walls.cellItems = cellItems;
+    walls.origin = glm::vec2(-100.0f, -100.0f);
+    walls.cellSize = 200.0f;
+    walls.width = 1;
+    walls.height = 1;
+    return walls;
+}
+
+// Balle qui glisse contre un mur, jusqu'au raccord avec le mur suivant : aucun contact
+GOLF_TEST(collisionSweepSliding)
+{
+    const WallSegment segments[] = {
+        { glm::vec2(5.0f, -20.0f), glm::vec2(5.0f, 20.0f) },
+        { glm::vec2(5.0f, 20.0f), glm::vec2(5.0f, 40.0f) },
+    };
+    const uint32_t cellItems[] = { 0, 1 };
+    const uint32_t cellStarts[] = { 0, 2 };
+    WallSet walls = makeWallSet(segments, cellStarts, cellItems);
+
+    glm::vec2 center(5.0f - ballRadius, 0.0f);
+    glm::vec2 delta(0.0f, 30.0f);
+    float time;
+    glm::vec2 normal;
+    CHECK(!sweepWall(segments[0], center, delta, 1.0f, time, normal));
+    CHECK(!sweepWall(segments[1], center, delta, 1.0f, time, normal));
+    CHECK(!sweepWalls(walls, center, delta, 1.0f, glm::vec2(0.0f), time, normal));
+
+    // Qui s'loigne du mur : aucun contact non plus
+    CHECK(!sweepWalls(walls, center, glm::vec2(-1.0f, 30.0f), 1.0f, glm::vec2(0.0f), time, normal));
+}
+
+// Balle lance vers un coin saillant, commun  deux murs : un seul impact, pas de nouveau contact au mme point
+GOLF_TEST(collisionSweepConvexCorner)
+{
+    const WallSegment segments[] = {
+        { glm::vec2(5.0f, -20.0f), glm::vec2(5.0f, 20.0f) },
+        { glm::vec2(5.0f, 20.0f), glm::vec2(40.0f, 20.0f) },
+    };
+    const uint32_t cellItems[] = { 0, 1 };
+    const uint32_t cellStarts[] = { 0, 2 };
+    WallSet walls = makeWallSet(segments, cellStarts, cellItems);
+
+    glm::vec2 center(1.0f, 24.0f);
+    glm::vec2 delta(10.0f, -10.0f);
+    float time;
+    glm::vec2 normal;
+    CHECK(sweepWalls(walls, center, delta, 1.0f, glm::vec2(0.0f), time, normal));
+    CHECK(isClose(glm::length(center + delta * time - glm::vec2(5.0f, 20.0f)), ballRadius));
+    CHECK(isClose(normal.x, -normal.y) && normal.x < 0.0f);
+
+    // Au point de contact, le contact qui vient d'tre rsolu n'est pas compt une deuxime fois,
+    // mme si la vitesse (arrondis de la rflexion) va encore un peu vers le coin
+    glm::vec2 contact = center + delta * time;
+    float nextTime;
+    glm::vec2 nextNormal;
+    CHECK(sweepWalls(walls, contact, delta, 1.0f, glm::vec2(0.0f), nextTime, nextNormal) && nextTime * glm::length(delta) < 1e-4f);
+    CHECK(!sweepWalls(walls, contact, delta, 1.0f, normal, nextTime, nextNormal));
+
+    // Aprs la rflexion, la balle s'loigne : plus aucun contact
+    glm::vec2 reflected = delta - normal * ((1.0f + dampingFactor) * glm::dot(delta, normal));
+    CHECK(!sweepWalls(walls, contact, reflected, 1.0f, glm::vec2(0.0f), nextTime, nextNormal));
+    CHECK(!sweepWalls(walls, contact, reflected, 1.0f, normal, nextTime, nextNormal));
+}
+
+// Sur les parcours du jeu, un pas continu ne compte jamais plus de deux impacts (un coin et un mur)
+GOLF_TEST(collisionContinuousContactsPerStep)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    int worstStep = 0;
+    for (int index = 0; index < courses.getCourseCount(); ++index)
+    {
+        for (int angle = 0; angle < 72; ++angle)
+        {
+            for (int power = 1; power <= 5; ++power)
+            {
+                Physics physics;
+                physics.setCourse(courses, index);
+                physics.setCollisionMode(ContinuousCollision);
+                physics.applyImpulse(getShotDirection(0.0f, angle * 6.2831853f / 72.0f) * (maxImpulseStrength * power / 5.0f));
+                for (int step = 0; step < 60 * 60 && !physics.isAsleep() && !physics.isInHole(); ++step)
+                {
+                    int before = physics.getWallContacts();
+                    physics.fixedStep();
+                    worstStep = std::max(worstStep, physics.getWallContacts() - before);
+                }
+            }
+        }
+    }
+    CHECK(worstStep <= 2);
+}
+
+// Quel que soit le tir, la balle reste entre les murs extrieurs du parcours
+GOLF_TEST(collisionShotsStayOnCourse)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    const CollisionMode modes[] = { DiscreteCollision, ContinuousCollision };
+    for (int index = 0; index < courses.getCourseCount(); ++index)
+    {
+        const Course& course = courses.getCourse(index);
+        const WallSegment* segments = courses.getWallSegments() + course.segmentFirst;
+        glm::vec2 minimum = glm::min(segments[0].start, segments[0].end);
+        glm::vec2 maximum = glm::max(segments[0].start, segments[0].end);
+        for (uint32_t i = 1; i < course.segmentCount; ++i)
+        {
+            minimum = glm::min(minimum, glm::min(segments[i].start, segments[i].end));
+            maximum = glm::max(maximum, glm::max(segments[i].start, segments[i].end));
+        }
+
+        for (CollisionMode mode : modes)
+        {
+            for (int angle = 0; angle < 36; ++angle)
+            {
+                for (int power = 1; power <= 4; ++power)
+                {
+                    glm::vec3 impulse = getShotDirection(0.0f, angle * 6.2831853f / 36.0f) * (maxImpulseStrength * power / 4.0f);
+                    ShotResult result = simulateShot(courses, index, impulse, 60 * 60, mode);
+                    glm::vec3 position = result.finalPosition;
+                    CHECK(position.x > minimum.x && position.x < maximum.x);
+                    CHECK(position.z > minimum.y && position.z < maximum.y);
+                }
+            }
+        }
+    }
+}
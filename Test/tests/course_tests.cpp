@@ -0,0 +1,175 @@
+#include "golf_test.h"
+#include "course.h"
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+static const char* const manifestPath = "golf_tests_manifest.txt";
+static const char* const coursePath = "golf_tests_course.txt";
+static const char* const cachePath = "golf_tests_manifest.bin";
+
+static void writeFile(const char* path, const char* contents)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    file << contents;
+}
+
+static void writeCourse(const char* contents)
+{
+    writeFile(manifestPath, "# Parcours de test\ngolf_tests_course.txt\n");
+    writeFile(coursePath, contents);
+    std::remove(cachePath);
+}
+
+static const char* const testCourse =
+    "par 4\n"
+    "tee 1 2\n"
+    "hole 10 20 # Commentaire\n"
+    "ground -5 -5 15 25\n"
+    "wall -5 -5 -5 25\n"
+    "wall 15 -5 15 25\n"
+    "wall -5 25 15 25\n";
+
+static bool sameLibrary(const CourseLibrary& first, const CourseLibrary& second)
+{
+    if (first.getCourseCount() != second.getCourseCount() || first.getVertexCount() != second.getVertexCount()
+        || first.getWallSegmentCount() != second.getWallSegmentCount())
+        return false;
+
+    for (int i = 0; i < first.getCourseCount(); ++i)
+    {
+        const Course& course = first.getCourse(i);
+        WallSet walls = first.getWalls(i);
+        WallSet otherWalls = second.getWalls(i);
+        uint32_t cellCount = course.gridWidth * course.gridHeight;
+        if (std::memcmp(&course, &second.getCourse(i), sizeof(Course)) != 0
+            || std::memcmp(walls.cellStarts, otherWalls.cellStarts, (cellCount + 1) * sizeof(uint32_t)) != 0
+            || std::memcmp(walls.cellItems + walls.cellStarts[0], otherWalls.cellItems + otherWalls.cellStarts[0],
+                (walls.cellStarts[cellCount] - walls.cellStarts[0]) * sizeof(uint32_t)) != 0)
+            return false;
+    }
+
+    return std::memcmp(first.getVertices(), second.getVertices(), first.getVertexCount() * courseVertexSize * sizeof(float)) == 0
+        && std::memcmp(first.getWallSegments(), second.getWallSegments(), first.getWallSegmentCount() * sizeof(WallSegment)) == 0;
+}
+
+GOLF_TEST(courseParseText)
+{
+    writeCourse(testCourse);
+
+    CourseLibrary courses;
+    CHECK(courses.load(manifestPath, cachePath));
+    CHECK(courses.getCourseCount() == 1);
+    if (courses.getCourseCount() != 1)
+        return;
+
+    const Course& course = courses.getCourse(0);
+    CHECK(course.par == 4);
+    CHECK(course.startPosition == glm::vec3(1.0f, ballRadius, 2.0f));
+    CHECK(course.holePosition == glm::vec3(10.0f, 0.0f, 20.0f));
+    CHECK(course.groundCount == 4);
+    CHECK(course.wallCount == 4 * 3);
+    CHECK(course.segmentCount == 3);
+    CHECK(courses.getWallSegmentCount() == 3);
+    CHECK(courses.getWallSegments()[2].start == glm::vec2(-5.0f, 25.0f));
+    CHECK(courses.getWallSegments()[2].end == glm::vec2(15.0f, 25.0f));
+}
+
+// Le cache relu sans recompilation donne exactement ce que la compilation a produit
+GOLF_TEST(courseCacheRoundTrip)
+{
+    writeCourse(testCourse);
+
+    CourseLibrary compiled;
+    CHECK(compiled.load(manifestPath, cachePath));
+
+    CourseLibrary cached;
+    CHECK(cached.load(manifestPath, cachePath));
+    CHECK(sameLibrary(compiled, cached));
+
+    // Mme chose pour les parcours du jeu
+    std::remove(testCourseCache);
+    CourseLibrary gameCompiled;
+    CHECK(gameCompiled.load(testCourseManifest, testCourseCache));
+    CourseLibrary gameCached;
+    CHECK(gameCached.load(testCourseManifest, testCourseCache));
+    CHECK(gameCompiled.getCourseCount() == 3);
+    CHECK(sameLibrary(gameCompiled, gameCached));
+}
+
+// Un parcours modifi rend le cache prim : il est recompil au chargement suivant
+GOLF_TEST(courseCacheInvalidation)
+{
+    writeCourse(testCourse);
+    CourseLibrary courses;
+    CHECK(courses.load(manifestPath, cachePath));
+    courses.unload();
+
+    std::string changed = testCourse;
+    changed.replace(changed.find("par 4"), 5, "par 12");
+    writeFile(coursePath, changed.c_str());
+
+    CHECK(courses.load(manifestPath, cachePath));
+    CHECK(courses.getCourseCount() == 1 && courses.getCourse(0).par == 12);
+}
+
+GOLF_TEST(courseRejectInvalid)
+{
+    CourseLibrary courses;
+
+    writeCourse("wall 1 2 1 2\n");
+    CHECK(!courses.load(manifestPath, cachePath));
+
+    writeCourse("wall 1 2 3\n");
+    CHECK(!courses.load(manifestPath, cachePath));
+
+    writeCourse("bunker 1 2 3 4\n");
+    CHECK(!courses.load(manifestPath, cachePath));
+
+    writeFile(manifestPath, "# Aucun parcours\n");
+    CHECK(!courses.load(manifestPath, cachePath));
+
+    CHECK(!courses.load("golf_tests_absent.txt", cachePath));
+}
+
+// Toute position  moins d'un rayon d'un mur est dans une case qui liste ce mur
+GOLF_TEST(courseWallGridCoversWalls)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    for (int index = 0; index < courses.getCourseCount(); ++index)
+    {
+        const Course& course = courses.getCourse(index);
+        WallSet walls = courses.getWalls(index);
+        for (uint32_t wall = course.segmentFirst; wall < course.segmentFirst + course.segmentCount; ++wall)
+        {
+            const WallSegment& segment = walls.segments[wall];
+            glm::vec2 direction = glm::normalize(segment.end - segment.start);
+            glm::vec2 normal(-direction.y, direction.x);
+            for (int sample = 0; sample <= 64; ++sample)
+            {
+                glm::vec2 point = glm::mix(segment.start, segment.end, sample / 64.0f);
+                for (float side = -1.0f; side <= 1.0f; side += 0.5f)
+                {
+                    glm::vec2 position = point + normal * side * ballRadius * 0.99f;
+                    int cellX = (int)std::floor((position.x - walls.origin.x) / walls.cellSize);
+                    int cellZ = (int)std::floor((position.y - walls.origin.y) / walls.cellSize);
+                    bool inside = cellX >= 0 && cellZ >= 0 && cellX < walls.width && cellZ < walls.height;
+                    CHECK(inside);
+                    if (!inside)
+                        continue;
+
+                    int cell = cellZ * walls.width + cellX;
+                    const uint32_t* first = walls.cellItems + walls.cellStarts[cell];
+                    const uint32_t* last = walls.cellItems + walls.cellStarts[cell + 1];
+                    CHECK(std::find(first, last, wall) != last);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <iostream>
+
+// Tests de non-rgression, lancs par ctest (un appel de golf_tests par groupe).
+// Chaque test est une fonction enregistre par GOLF_TEST ; son nom commence par celui de son groupe.
+// CHECK signale un chec sur std::cerr sans interrompre le test.
+//
+//     GOLF_TEST(physicsSameShotSameState)
+//     {
+//         CHECK(first == second);
+//     }
+
+typedef void (*TestFunction)();
+
+bool registerTest(const char* name, TestFunction function);
+void reportFailure(const char* file, int line, const char* expression);
+
+#define GOLF_TEST(name) \
+    static void name(); \
+    static const bool name##Registered = registerTest(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) reportFailure(__FILE__, __LINE__, #expression); } while (0)
+
+// Manifeste des parcours du jeu, et cache compil dans le rpertoire de travail des tests
+// (le cache du jeu,  ct du manifeste, n'est pas touch)
+const char* const testCourseManifest = GOLF_TEST_COURSES;
+const char* const testCourseCache = "golf_tests_courses.bin";
@@ -0,0 +1,63 @@
+// Lance les tests de non-rgression.
+//
+// Usage : golf_tests [groupe]    (sans groupe : tous les tests ; un groupe sans test est une erreur)
+
+#include "golf_test.h"
+#include <cstring>
+#include <vector>
+
+struct RegisteredTest
+{
+    const char* name;
+    TestFunction function;
+};
+
+// Construite au premier enregistrement : l'ordre d'initialisation des fichiers n'est pas garanti
+static std::vector<RegisteredTest>& getTests()
+{
+    static std::vector<RegisteredTest> tests;
+    return tests;
+}
+
+static int failures = 0;
+
+bool registerTest(const char* name, TestFunction function)
+{
+    getTests().push_back(RegisteredTest{ name, function });
+    return true;
+}
+
+void reportFailure(const char* file, int line, const char* expression)
+{
+    std::cerr << file << ":" << line << " : chec de " << expression << std::endl;
+    failures++;
+}
+
+int main(int argc, char** argv)
+{
+    const char* group = argc > 1 ? argv[1] : "";
+
+    int run = 0;
+    int failed = 0;
+    for (const RegisteredTest& test : getTests())
+    {
+        if (std::strncmp(test.name, group, std::strlen(group)) != 0)
+            continue;
+
+        int before = failures;
+        test.function();
+        run++;
+        if (failures != before)
+            failed++;
+        std::cout << (failures == before ? "OK     " : "CHEC  ") << test.name << std::endl;
+    }
+
+    if (run == 0)
+    {
+        std::cerr << "Aucun test dans le groupe " << group << std::endl;
+        return 1;
+    }
+
+    std::cout << run - failed << "/" << run << " tests russis" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "golf_test.h"
+#include "physics.h"
+#include <cmath>
+#include <cstring>
+
+static bool sameState(const Physics& first, const Physics& second)
+{
+    return std::memcmp(&first.getBall(), &second.getBall(), sizeof(BallState)) == 0
+        && first.isInHole() == second.isInHole()
+        && first.getWallContacts() == second.getWallContacts()
+        && first.isAsleep() == second.isAsleep()
+        && first.getStepCount() == second.getStepCount();
+}
+
+// Mmes entres, mme tat final, bit  bit, dans les deux modes de collision
+GOLF_TEST(physicsSameShotSameState)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    const CollisionMode modes[] = { DiscreteCollision, ContinuousCollision };
+    for (CollisionMode mode : modes)
+    {
+        for (int index = 0; index < courses.getCourseCount(); ++index)
+        {
+            Physics first;
+            Physics second;
+            Physics* both[] = { &first, &second };
+            for (Physics* physics : both)
+            {
+                physics->setCourse(courses, index);
+                physics->setCollisionMode(mode);
+                physics->applyImpulse(getShotDirection(0.0f, 0.3f) * 1.7f);
+                for (int step = 0; step < 600; ++step)
+                    physics->fixedStep();
+            }
+            CHECK(sameState(first, second));
+        }
+    }
+}
+
+// step() ne fait que des pas fixes : le dcoupage du temps de rendu ne change pas le rsultat
+GOLF_TEST(physicsStepUsesFixedSteps)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics rendered;
+    rendered.setCourse(courses, 0);
+    rendered.applyImpulse(getShotDirection(0.0f, 0.0f) * 1.5f);
+
+    const double frameTimes[] = { 0.007, 0.016, 0.033, 0.001, 0.021, 0.0167 };
+    int steps = 0;
+    for (int frame = 0; frame < 300; ++frame)
+        steps += rendered.step(frameTimes[frame % 6]);
+
+    Physics fixed;
+    fixed.setCourse(courses, 0);
+    fixed.applyImpulse(getShotDirection(0.0f, 0.0f) * 1.5f);
+    for (int step = 0; step < steps; ++step)
+        fixed.fixedStep();
+
+    CHECK(steps == rendered.getStepCount());
+    CHECK(sameState(rendered, fixed));
+
+    // Le reste d'une image est gard pour la suivante
+    Physics partial;
+    partial.setCourse(courses, 0);
+    CHECK(partial.step(fixedTimeStep * 0.6) == 0);
+    CHECK(partial.step(fixedTimeStep * 0.6) == 1);
+
+    // Une image trop longue est plafonne et son retard abandonn
+    CHECK(partial.step(1.0) == maxStepsPerUpdate);
+    CHECK(partial.step(0.0) == 0);
+}
+
+GOLF_TEST(physicsSleepAtRest)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics physics;
+    physics.setCourse(courses, 0);
+    physics.applyImpulse(getShotDirection(0.0f, 0.0f) * 0.3f);
+    CHECK(!physics.isAsleep());
+
+    // Endormie seulement aprs sleepSteps pas conscutifs  l'arrt
+    int restingSteps = 0;
+    for (int step = 0; step < 60 * 60 && !physics.isAsleep(); ++step)
+    {
+        physics.fixedStep();
+        restingSteps = physics.isAtRest() ? restingSteps + 1 : 0;
+    }
+    CHECK(physics.isAsleep());
+    CHECK(restingSteps == sleepSteps);
+    CHECK(physics.getBall().velocity == glm::vec3(0.0f));
+
+    // Endormie, la balle ne bouge plus et ses pas sont compts comme vits
+    BallState ball = physics.getBall();
+    long long skipped = physics.getSkippedSteps();
+    long long stepCount = physics.getStepCount();
+    for (int step = 0; step < 100; ++step)
+        physics.fixedStep();
+    CHECK(std::memcmp(&ball, &physics.getBall(), sizeof(BallState)) == 0);
+    CHECK(physics.getSkippedSteps() == skipped + 100);
+    CHECK(physics.getStepCount() == stepCount + 100);
+
+    // Un tir la rveille
+    physics.applyImpulse(getShotDirection(0.0f, 0.0f) * 0.3f);
+    CHECK(!physics.isAsleep());
+    physics.fixedStep();
+    CHECK(physics.getBall().position != ball.position);
+    CHECK(physics.getSkippedSteps() == skipped + 100);
+}
+
+// La prdiction d'impact en impact compte les impacts comme la simulation continue et s'arrte au mme endroit.
+// Seuls quelques tirs qui frlent un coin s'cartent un peu : les arrondis y changent la rflexion.
+GOLF_TEST(physicsPredictionMatchesSimulation)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    int shots = 0;
+    int mismatches = 0;
+    int apart = 0;
+    for (int index = 0; index < courses.getCourseCount(); ++index)
+    {
+        for (int angle = 0; angle < 72; ++angle)
+        {
+            for (int power = 1; power <= 10; ++power)
+            {
+                glm::vec3 impulse = getShotDirection(0.0f, angle * 6.2831853f / 72.0f) * (maxImpulseStrength * power / 10.0f);
+                ShotResult simulated = simulateShot(courses, index, impulse, maxPredictionSteps, ContinuousCollision);
+                ShotResult predicted = predictShot(courses, index, impulse);
+                shots++;
+                if (predicted.wallContacts != simulated.wallContacts || predicted.inHole != simulated.inHole
+                    || std::abs(predicted.steps - simulated.steps) > 1)
+                    mismatches++;
+                if (glm::distance(predicted.finalPosition, simulated.finalPosition) > 0.05f)
+                    apart++;
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(apart * 100 <= shots);
+
+    // Tir qui frle le coin saillant (5.5, 50) du premier parcours
+    glm::vec3 impulse = getShotDirection(0.0f, 0.139626f) * 1.86f;
+    ShotResult simulated = simulateShot(courses, 0, impulse, maxPredictionSteps, ContinuousCollision);
+    ShotResult predicted = predictShot(courses, 0, impulse);
+    CHECK(predicted.wallContacts == simulated.wallContacts);
+    CHECK(glm::distance(predicted.finalPosition, simulated.finalPosition) < 0.05f);
+}
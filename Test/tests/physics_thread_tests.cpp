@@ -0,0 +1,136 @@
+#include "golf_test.h"
+#include "physics_thread.h"
+#include <chrono>
+#include <thread>
+
+GOLF_TEST(threadTripleBuffer)
+{
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.update());
+
+    buffer.getBack() = 1;
+    buffer.publish();
+    CHECK(buffer.update());
+    CHECK(buffer.getFront() == 1);
+    CHECK(!buffer.update()); // Dj lue
+    CHECK(buffer.getFront() == 1);
+
+    // Seule la dernire valeur publie compte
+    buffer.getBack() = 2;
+    buffer.publish();
+    buffer.getBack() = 3;
+    buffer.publish();
+    CHECK(buffer.update());
+    CHECK(buffer.getFront() == 3);
+
+    // Entre deux threads : le lecteur ne voit jamais une valeur plus ancienne que la prcdente
+    const int count = 200000;
+    std::thread writer([&buffer]()
+    {
+        for (int value = 4; value <= count; ++value)
+        {
+            buffer.getBack() = value;
+            buffer.publish();
+        }
+    });
+
+    int last = 3;
+    bool ordered = true;
+    while (last < count)
+    {
+        if (buffer.update())
+        {
+            ordered &= buffer.getFront() > last;
+            last = buffer.getFront();
+        }
+    }
+    writer.join();
+    CHECK(ordered);
+}
+
+GOLF_TEST(threadSpscQueue)
+{
+    SpscQueue<int, 8> queue;
+    int value = 0;
+    CHECK(!queue.pop(value));
+
+    // Une case reste vide : 7 entres au plus, la suivante est refuse
+    for (int i = 0; i < 7; ++i)
+        CHECK(queue.push(i));
+    CHECK(!queue.push(7));
+
+    for (int i = 0; i < 7; ++i)
+    {
+        CHECK(queue.pop(value));
+        CHECK(value == i);
+    }
+    CHECK(!queue.pop(value));
+
+    // Entre deux threads : tout arrive, dans l'ordre
+    const int count = 200000;
+    std::thread producer([&queue]()
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            while (!queue.push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    bool ordered = true;
+    for (int expected = 0; expected < count; ++expected)
+    {
+        while (!queue.pop(value))
+            std::this_thread::yield();
+        ordered &= value == expected;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(!queue.pop(value));
+}
+
+// Les entres du thread de rendu sont appliques par le thread de simulation, dans l'ordre
+GOLF_TEST(threadPhysicsInputs)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics physics;
+    PhysicsThread physicsThread;
+    physicsThread.start(physics, courses, 1, nullptr, nullptr);
+    CHECK(physicsThread.getSnapshot().course == 1);
+
+    CHECK(physicsThread.pushInput(PhysicsInput{ PhysicsInputCourse, glm::vec3(0.0f), 0.0f, 2 }));
+    CHECK(physicsThread.pushInput(PhysicsInput{ PhysicsInputCamera, glm::vec3(0.1f, 0.2f, 7.0f), 0.0f, 0 }));
+    CHECK(physicsThread.pushInput(PhysicsInput{ PhysicsInputShot, glm::vec3(0.0f, 0.0f, 1.0f), 0.5f, 0 }));
+    CHECK(physicsThread.getPushedInputCount() == 2); // La camra ne compte pas
+
+    for (int wait = 0; wait < 500 && physicsThread.getSnapshot().inputCount < 2; ++wait)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        physicsThread.updateSnapshot();
+    }
+    physicsThread.stop();
+
+    CHECK(physicsThread.getSnapshot().inputCount == 2);
+    CHECK(physicsThread.getCourse() == 2);
+    CHECK(&physics.getCourse() == &courses.getCourse(2));
+    CHECK(physics.getBall().position != courses.getCourse(2).startPosition || physics.getBall().velocity != glm::vec3(0.0f));
+}
+
+// Le thread tourne plus vite que la simulation, mais les pas fixes gardent le rythme de fixedTimeStep
+GOLF_TEST(threadStepsAtFixedRate)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics physics;
+    PhysicsThread physicsThread;
+    physicsThread.start(physics, courses, 0, nullptr, nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    physicsThread.stop();
+
+    double elapsed = physicsThread.getTime();
+    CHECK(physics.getStepCount() > 0);
+    CHECK(physics.getStepCount() + physicsThread.getDroppedSteps() <= (long long)(elapsed / fixedTimeStep) + 1);
+}
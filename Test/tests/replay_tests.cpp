@@ -0,0 +1,191 @@
+#include "golf_test.h"
+#include "replay.h"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static const char* const replayPath = "golf_tests_replay.rec";
+
+// Une partie courte sur deux parcours : tirs, remise  zro, changement de parcours et camra
+static void playGame(const CourseLibrary& courses, Physics& physics, ReplayRecorder& recorder, int& course)
+{
+    recorder.start(replayPath);
+    course = 0;
+    physics.setCourse(courses, course);
+    recorder.recordCourse(physics, course);
+
+    for (int step = 0; step < 900; ++step)
+    {
+        if (step == 10 || step == 400)
+        {
+            glm::vec3 impulse = getShotDirection(0.0f, 0.1f * step / 10.0f) * 1.2f;
+            physics.applyImpulse(impulse);
+            recorder.recordShot(physics, impulse, 0.5f);
+        }
+        if (step == 300)
+        {
+            physics.reset();
+            recorder.recordReset(physics);
+        }
+        if (step == 600)
+        {
+            course = 1;
+            physics.setCourse(courses, course);
+            recorder.recordCourse(physics, course);
+            glm::vec3 impulse = getShotDirection(0.0f, -0.2f) * 1.9f;
+            physics.applyImpulse(impulse);
+            recorder.recordShot(physics, impulse, 0.8f);
+        }
+        if (step % 50 == 0)
+            recorder.recordCamera(physics, 0.01f * step, 1.0f, 7.0f);
+        physics.fixedStep();
+    }
+}
+
+GOLF_TEST(replayRoundTrip)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics recorded;
+    ReplayRecorder recorder;
+    int recordedCourse = 0;
+    playGame(courses, recorded, recorder, recordedCourse);
+    CHECK(recorder.save(recorded, recordedCourse));
+
+    ReplayPlayer player;
+    CHECK(player.load(replayPath, courses));
+    CHECK(player.getStepCount() == 900);
+
+    // Deux relectures de suite : mme tat final que l'enregistrement, bit  bit
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        player.rewind();
+        Physics physics;
+        int course = 0;
+        player.run(physics, courses, course);
+        CHECK(course == 1);
+        CHECK(player.isFinished(physics));
+        CHECK(player.verify(physics, course));
+        CHECK(std::memcmp(&physics.getBall(), &recorded.getBall(), sizeof(BallState)) == 0);
+        CHECK(player.getCamera().valid && player.getCamera().angleX == 0.01f * 850);
+    }
+
+    // Relecture au rythme du rendu : mme rsultat
+    player.rewind();
+    Physics physics;
+    int course = 0;
+    for (int frame = 0; frame < 2000 && !player.isFinished(physics); ++frame)
+        player.step(physics, courses, course, 0.011);
+    CHECK(player.verify(physics, course));
+}
+
+GOLF_TEST(replayVerifyDetectsDivergence)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics recorded;
+    ReplayRecorder recorder;
+    int course = 0;
+    playGame(courses, recorded, recorder, course);
+    CHECK(recorder.save(recorded, course));
+
+    ReplayPlayer player;
+    CHECK(player.load(replayPath, courses));
+
+    // Balle dplace aprs la fin de l'enregistrement, ou mauvais parcours : divergence signale
+    Physics physics;
+    int playedCourse = 0;
+    player.run(physics, courses, playedCourse);
+    Physics moved(physics);
+    moved.applyImpulse(glm::vec3(0.1f, 0.0f, 0.0f));
+    moved.fixedStep();
+    CHECK(!player.verify(moved, playedCourse));
+    CHECK(!player.verify(physics, 0));
+
+    // Fichier tronqu ou qui n'est pas un enregistrement
+    std::ofstream truncated(replayPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    truncated << "GREC";
+    truncated.close();
+    CHECK(!player.load(replayPath, courses));
+    CHECK(!player.load("golf_tests_absent.rec", courses));
+}
+
+static void writeReplay(const std::string& contents)
+{
+    std::ofstream file(replayPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+}
+
+// Champs lus dans le fichier avant toute allocation ou tout changement de parcours
+GOLF_TEST(replayRejectsInvalidFiles)
+{
+    CourseLibrary courses;
+    CHECK(courses.load(testCourseManifest, testCourseCache));
+
+    Physics recorded;
+    ReplayRecorder recorder;
+    int course = 0;
+    playGame(courses, recorded, recorder, course);
+    CHECK(recorder.save(recorded, course));
+
+    std::ifstream file(replayPath, std::ios::in | std::ios::binary);
+    std::string original((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    ReplayHeader header;
+    std::memcpy(&header, original.data(), sizeof(header));
+    ReplayPlayer player;
+
+    // Nombre d'vnements plus grand que le fichier
+    std::string contents = original;
+    uint32_t eventCount = 0xFFFFFFFFu;
+    std::memcpy(&contents[offsetof(ReplayHeader, eventCount)], &eventCount, sizeof(eventCount));
+    writeReplay(contents);
+    CHECK(!player.load(replayPath, courses));
+    CHECK(!player.isLoaded());
+
+    eventCount = header.eventCount + 1;
+    std::memcpy(&contents[offsetof(ReplayHeader, eventCount)], &eventCount, sizeof(eventCount));
+    writeReplay(contents);
+    CHECK(!player.load(replayPath, courses));
+
+    // Parcours final hors de la bibliothque
+    contents = original;
+    int32_t finalCourse = courses.getCourseCount();
+    std::memcpy(&contents[offsetof(ReplayHeader, finalCourse)], &finalCourse, sizeof(finalCourse));
+    writeReplay(contents);
+    CHECK(!player.load(replayPath, courses));
+
+    finalCourse = -1;
+    std::memcpy(&contents[offsetof(ReplayHeader, finalCourse)], &finalCourse, sizeof(finalCourse));
+    writeReplay(contents);
+    CHECK(!player.load(replayPath, courses));
+
+    // Changement de parcours vers un indice absent, ngatif ou non entier
+    const float badCourses[] = { (float)courses.getCourseCount(), -1.0f, 0.5f };
+    for (float badCourse : badCourses)
+    {
+        contents = original;
+        for (uint32_t i = 0; i < header.eventCount; ++i)
+        {
+            ReplayEvent event;
+            size_t offset = sizeof(ReplayHeader) + i * sizeof(ReplayEvent);
+            std::memcpy(&event, &contents[offset], sizeof(event));
+            if (event.type == ReplayCourse)
+            {
+                event.values[0] = badCourse;
+                std::memcpy(&contents[offset], &event, sizeof(event));
+            }
+        }
+        writeReplay(contents);
+        CHECK(!player.load(replayPath, courses));
+    }
+
+    // Le fichier d'origine reste valide
+    writeReplay(original);
+    CHECK(player.load(replayPath, courses));
+}
@@ -1,12 +1,12 @@
 #version 330 core
 in vec2 TexCoords;
+in vec3 TextColor;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
 
+// Couleur par sommet : toutes les chaines du HUD partagent une seule commande de dessin
 void main()
-{    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
+{
+    color = vec4(TextColor, texture(text, TexCoords).r);
 }
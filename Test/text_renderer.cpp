@@ -0,0 +1,350 @@
+#include "text_renderer.h"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Fichier de cache : en-tte, table des glyphes puis pixels de l'atlas (un octet par pixel)
+struct FontAtlasHeader
+{
+    char magic[4];          // "GFNT"
+    uint32_t version;
+    uint64_t fontHash;      // Contenu du fichier de police
+    uint32_t pixelSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t glyphCount;
+    float lineHeight;
+    uint32_t reserved;
+};
+
+const char fontAtlasMagic[4] = { 'G', 'F', 'N', 'T' };
+const uint32_t fontAtlasVersion = 1;
+const int maxFontAtlasHeight = 2048;
+
+static bool readFontFile(const char* path, std::string& data)
+{
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+        std::cerr << "Impossible d'ouvrir la police " << path << std::endl;
+        return false;
+    }
+
+    std::stringstream sstr;
+    sstr << stream.rdbuf();
+    data = sstr.str();
+    return true;
+}
+
+static uint64_t hashFontData(const std::string& data)
+{
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (unsigned char byte : data)
+    {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::string getAtlasCachePath(const char* fontPath, int pixelSize)
+{
+    return std::string(fontPath) + "." + std::to_string(pixelSize) + ".atlas";
+}
+
+FontAtlas::FontAtlas()
+    : pixelSize(0), lineHeight(0.0f), cached(false)
+{
+    std::memset(glyphs, 0, sizeof(glyphs));
+}
+
+bool FontAtlas::rasterize(const char* fontPath, std::vector<unsigned char>& pixels, int& height)
+{
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+    {
+        std::cerr << "chec de l'initialisation de FreeType" << std::endl;
+        return false;
+    }
+
+    FT_Face face;
+    if (FT_New_Face(library, fontPath, 0, &face))
+    {
+        std::cerr << "Police illisible : " << fontPath << std::endl;
+        FT_Done_FreeType(library);
+        return false;
+    }
+    FT_Set_Pixel_Sizes(face, 0, pixelSize);
+    lineHeight = (float)(face->size->metrics.height >> 6);
+
+    // Ranges de glyphes de gauche  droite, un pixel de marge pour le filtrage linaire
+    pixels.assign((size_t)fontAtlasWidth * maxFontAtlasHeight, 0);
+    int x = 1, y = 1, rowHeight = 0;
+    std::vector<int> glyphX(atlasGlyphCount), glyphY(atlasGlyphCount);
+    for (int i = 0; i < atlasGlyphCount; ++i)
+    {
+        GlyphInfo& glyph = glyphs[i];
+        std::memset(&glyph, 0, sizeof(glyph));
+        unsigned long code = firstAtlasGlyph + i;
+        if ((code >= 127 && code < 160) || FT_Load_Char(face, code, FT_LOAD_RENDER))
+            continue; // Caractres de contrle, ou absents de la police
+
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        if (x + (int)bitmap.width + 1 > fontAtlasWidth)
+        {
+            x = 1;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        if (y + (int)bitmap.rows + 1 > maxFontAtlasHeight)
+        {
+            std::cerr << "Police trop grande pour l'atlas : " << fontPath << " (" << pixelSize << " px)" << std::endl;
+            break;
+        }
+
+        for (unsigned int row = 0; row < bitmap.rows; ++row)
+            std::memcpy(&pixels[(size_t)(y + row) * fontAtlasWidth + x], bitmap.buffer + row * bitmap.pitch, bitmap.width);
+
+        glyph.width = (float)bitmap.width;
+        glyph.height = (float)bitmap.rows;
+        glyph.bearingX = (float)face->glyph->bitmap_left;
+        glyph.bearingY = (float)face->glyph->bitmap_top;
+        glyph.advance = (float)(face->glyph->advance.x >> 6);
+        glyphX[i] = x;
+        glyphY[i] = y;
+
+        x += bitmap.width + 1;
+        rowHeight = std::max(rowHeight, (int)bitmap.rows);
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+
+    // Hauteur arrondie  la puissance de deux suprieure
+    height = 1;
+    while (height < y + rowHeight + 1)
+        height *= 2;
+    pixels.resize((size_t)fontAtlasWidth * height);
+
+    for (int i = 0; i < atlasGlyphCount; ++i)
+    {
+        GlyphInfo& glyph = glyphs[i];
+        glyph.u0 = (float)glyphX[i] / fontAtlasWidth;
+        glyph.v0 = (float)glyphY[i] / height;
+        glyph.u1 = (glyphX[i] + glyph.width) / fontAtlasWidth;
+        glyph.v1 = (glyphY[i] + glyph.height) / height;
+    }
+    return true;
+}
+
+bool FontAtlas::load(const char* fontPath, int size, bool useCache)
+{
+    release();
+    pixelSize = size;
+    cached = false;
+
+    std::string fontData;
+    if (!readFontFile(fontPath, fontData))
+        return false;
+    uint64_t fontHash = hashFontData(fontData);
+    std::string cachePath = getAtlasCachePath(fontPath, size);
+
+    std::vector<unsigned char> pixels;
+    int height = 0;
+    if (useCache)
+    {
+        std::ifstream cache(cachePath, std::ios::in | std::ios::binary);
+        FontAtlasHeader header;
+        if (cache.read(reinterpret_cast<char*>(&header), sizeof(header))
+            && std::memcmp(header.magic, fontAtlasMagic, sizeof(header.magic)) == 0 && header.version == fontAtlasVersion
+            && header.fontHash == fontHash && header.pixelSize == (uint32_t)size && header.width == (uint32_t)fontAtlasWidth
+            && header.glyphCount == (uint32_t)atlasGlyphCount && header.height <= (uint32_t)maxFontAtlasHeight)
+        {
+            pixels.resize((size_t)header.width * header.height);
+            cached = cache.read(reinterpret_cast<char*>(glyphs), sizeof(glyphs))
+                && cache.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+            height = (int)header.height;
+            lineHeight = header.lineHeight;
+        }
+    }
+
+    if (!cached)
+    {
+        if (!rasterize(fontPath, pixels, height))
+            return false;
+
+        if (useCache)
+        {
+            FontAtlasHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, fontAtlasMagic, sizeof(header.magic));
+            header.version = fontAtlasVersion;
+            header.fontHash = fontHash;
+            header.pixelSize = size;
+            header.width = fontAtlasWidth;
+            header.height = height;
+            header.glyphCount = atlasGlyphCount;
+            header.lineHeight = lineHeight;
+
+            std::ofstream cache(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            cache.write(reinterpret_cast<const char*>(glyphs), sizeof(glyphs));
+            cache.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+            if (!cache.good())
+                std::cerr << "Impossible d'crire " << cachePath << std::endl;
+        }
+    }
+
+    // Un seul canal : le fragment shader s'en sert comme opacit
+    texture.create();
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, fontAtlasWidth, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    texture.setByteSize((size_t)fontAtlasWidth * height);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void FontAtlas::release()
+{
+    texture.reset();
+}
+
+bool FontAtlas::isLoaded() const
+{
+    return texture != 0;
+}
+
+bool FontAtlas::wasCached() const
+{
+    return cached;
+}
+
+GLuint FontAtlas::getTexture() const
+{
+    return texture;
+}
+
+float FontAtlas::getLineHeight() const
+{
+    return lineHeight;
+}
+
+const GlyphInfo* FontAtlas::getGlyph(unsigned char c) const
+{
+    if (c < firstAtlasGlyph)
+        return nullptr;
+    return &glyphs[c - firstAtlasGlyph];
+}
+
+float FontAtlas::measure(const std::string& text, float scale) const
+{
+    float width = 0.0f;
+    for (unsigned char c : text)
+    {
+        const GlyphInfo* glyph = getGlyph(c);
+        if (glyph)
+            width += glyph->advance * scale;
+    }
+    return width;
+}
+
+TextBatch::TextBatch()
+{
+}
+
+void TextBatch::setup(const StreamBuffer& stream)
+{
+
+    vao.create();
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (GLvoid*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (GLvoid*)(4 * sizeof(GLfloat)));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TextBatch::release()
+{
+    vao.reset();
+}
+
+void TextBatch::addText(const FontAtlas& font, const std::string& text, float x, float y, float scale, const glm::vec3& color)
+{
+    for (unsigned char c : text)
+    {
+        const GlyphInfo* glyph = font.getGlyph(c);
+        if (!glyph)
+            continue;
+
+        if (glyph->width > 0.0f)
+        {
+            float x0 = x + glyph->bearingX * scale;
+            float y1 = y + glyph->bearingY * scale;
+            float x1 = x0 + glyph->width * scale;
+            float y0 = y1 - glyph->height * scale;
+
+            // Deux triangles par glyphe ; l'atlas est rang de haut en bas
+            TextVertex quad[6] =
+            {
+                { x0, y1, glyph->u0, glyph->v0, color.r, color.g, color.b },
+                { x0, y0, glyph->u0, glyph->v1, color.r, color.g, color.b },
+                { x1, y0, glyph->u1, glyph->v1, color.r, color.g, color.b },
+                { x0, y1, glyph->u0, glyph->v0, color.r, color.g, color.b },
+                { x1, y0, glyph->u1, glyph->v1, color.r, color.g, color.b },
+                { x1, y1, glyph->u1, glyph->v0, color.r, color.g, color.b }
+            };
+            vertices.insert(vertices.end(), quad, quad + 6);
+        }
+        x += glyph->advance * scale;
+    }
+}
+
+void TextBatch::clear()
+{
+    vertices.clear();
+}
+
+bool TextBatch::isEmpty() const
+{
+    return vertices.empty();
+}
+
+GLint TextBatch::upload(StreamBuffer& stream)
+{
+    // Align sur la taille d'un sommet : le dcalage devient un numro de premier sommet
+    size_t size = sizeof(TextVertex) * vertices.size();
+    StreamAllocation allocation = stream.allocate(size, sizeof(TextVertex));
+    if (!allocation.pointer)
+        return -1;
+
+    std::memcpy(allocation.pointer, vertices.data(), size);
+    return (GLint)(allocation.offset / sizeof(TextVertex));
+}
+
+GLsizei TextBatch::getVertexCount() const
+{
+    return (GLsizei)vertices.size();
+}
+
+GLuint TextBatch::getVAO() const
+{
+    return vao;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm.hpp>
+#include "gl_resource.h"
+#include "stream_buffer.h"
+#include <string>
+#include <vector>
+
+// Texte du HUD. Les glyphes d'une police sont rastriss une seule fois par FreeType dans une
+// texture unique (l'atlas), garde sur disque  ct de la police pour les dmarrages suivants.
+// Les chanes d'une image sont accumules puis crites d'un bloc dans le tampon de flux de la
+// scne et dessines en une commande, sans changer de texture d'un glyphe  l'autre.
+
+const int firstAtlasGlyph = 32;     // Espace
+const int atlasGlyphCount = 224;    // Jusqu' 255 : les sources sont en Latin-1, un char y est un caractre
+const int fontAtlasWidth = 512;
+
+struct GlyphInfo
+{
+    float u0, v0, u1, v1;   // Coordonnes dans l'atlas (v0 : haut du glyphe)
+    float width;            // Taille du bitmap, en pixels de la police
+    float height;
+    float bearingX;         // Dcalage du bitmap par rapport au point de dpart et  la ligne de base
+    float bearingY;
+    float advance;
+};
+
+class FontAtlas
+{
+
+public:
+
+    FontAtlas();
+
+    // Relit l'atlas depuis fontPath.<taille>.atlas s'il correspond  la police, sinon le rastrise
+    // et rcrit ce fichier. Le contexte OpenGL doit tre courant.
+    bool load(const char* fontPath, int pixelSize, bool useCache = true);
+    void release();
+
+    bool isLoaded() const;
+    bool wasCached() const; // Le dernier load() a lu le fichier au lieu d'appeler FreeType
+    GLuint getTexture() const;
+    float getLineHeight() const;
+    const GlyphInfo* getGlyph(unsigned char c) const; // nullptr hors de l'atlas
+    float measure(const std::string& text, float scale) const; // Largeur de la chane
+
+private:
+
+    GlTexture texture;
+    int pixelSize;
+    float lineHeight;
+    bool cached;
+    GlyphInfo glyphs[atlasGlyphCount];
+
+    bool rasterize(const char* fontPath, std::vector<unsigned char>& pixels, int& height);
+};
+
+// Sommet de texte : position, coordonnes dans l'atlas, couleur
+struct TextVertex
+{
+    float x, y;
+    float u, v;
+    float r, g, b;
+};
+
+class TextBatch
+{
+
+public:
+
+    TextBatch();
+
+    void setup(const StreamBuffer& stream); // VAO lisant le tampon de flux, une fois le contexte cr
+    void release();
+
+    // (x, y) : dbut de la ligne de base, dans le repre de la jauge (800x600, y vers le haut)
+    void addText(const FontAtlas& font, const std::string& text, float x, float y, float scale, const glm::vec3& color);
+    void clear();
+    bool isEmpty() const;
+
+    // crit les sommets accumuls dans la rgion de l'image ; renvoie le premier sommet, -1 si
+    // la rgion est pleine
+    GLint upload(StreamBuffer& stream);
+    GLsizei getVertexCount() const;
+    GLuint getVAO() const;
+
+private:
+
+    GlVertexArray vao;
+    std::vector<TextVertex> vertices;
+};
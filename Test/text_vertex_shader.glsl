@@ -1,12 +1,22 @@
 #version 330 core
 layout(location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout(location = 1) in vec3 aColor;
 
 out vec2 TexCoords;
+out vec3 TextColor;
 
-uniform mat4 projection;
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+    gl_Position = screenProjection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
+    TextColor = aColor;
 }
@@ -0,0 +1,30 @@
+// Compile les parcours texte lists dans un manifeste en cache binaire projetable en mmoire.
+// Le jeu le fait lui-mme au dmarrage si le cache est absent ou prim ; cet outil sert  le prparer  l'avance.
+//
+// Usage : course_compiler [manifeste] [sortie.bin]
+
+#include "course.h"
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    const char* manifestPath = argc > 1 ? argv[1] : defaultCourseManifest;
+
+    std::string cachePath = argc > 2 ? argv[2] : getCourseCachePath(manifestPath);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Relire le cache juste crit pour vrifier qu'il se projette correctement
+    CourseLibrary courses;
+    if (!compileCourses(manifestPath, cachePath.c_str()) || !courses.load(manifestPath, cachePath.c_str()))
+    {
+        std::cerr << "chec de la compilation des parcours" << std::endl;
+        return 1;
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << courses.getCourseCount() << " parcours, " << courses.getVertexCount() << " sommets, "
+              << courses.getWallSegmentCount() << " murs (" << milliseconds << " ms)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,351 @@
+// Micro-benchmarks de la simulation, des collisions et du rendu (Google Benchmark).
+// Le rendu passe par un contexte EGL sans fentre (Mesa llvmpipe), les benchmarks OpenGL
+// sont ignors si aucun contexte ne peut tre cr.
+//
+//  lancer depuis le dossier Test (shaders et parcours). Les rsultats sont aussi crits en JSON
+// dans golf_bench.json, sauf si --benchmark_out est donn.
+//
+// Usage : golf_bench [options de Google Benchmark]
+
+#include "headless_gl.h"
+#include "physics.h"
+#include "scene.h"
+#include "sphere.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+const int benchWidth = 1080; // Taille de la fentre du jeu
+const int benchHeight = 720;
+const int samplePositionCount = 1024;
+
+CourseLibrary courses;
+bool glReady = false;
+
+// Positions de balle autour des murs d'un parcours, la moiti en contact
+static void makeWallSamples(int course, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& velocities)
+{
+    const Course& info = courses.getCourse(course);
+    const WallSegment* segments = courses.getWallSegments() + info.segmentFirst;
+
+    std::mt19937 random(course);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < samplePositionCount; ++i)
+    {
+        const WallSegment& segment = segments[random() % info.segmentCount];
+        glm::vec2 direction = segment.end - segment.start;
+        glm::vec2 normal = glm::normalize(glm::vec2(-direction.y, direction.x));
+        glm::vec2 point = segment.start + direction * unit(random) + normal * ((unit(random) * 2.0f - 1.0f) * 2.0f * ballRadius);
+
+        positions.push_back(glm::vec3(point.x, ballRadius, point.y));
+        velocities.push_back(glm::vec3(unit(random) - 0.5f, 0.0f, unit(random) - 0.5f) * maxImpulseStrength);
+    }
+}
+
+static bool requireGL(benchmark::State& state)
+{
+    if (!glReady)
+        state.SkipWithError("Pas de contexte OpenGL");
+    return glReady;
+}
+
+// Un pas fixe de la balle (l'ancienne boucle de sous-tapes de draw(), ou la collision continue)
+static void BM_PhysicsFixedStep(benchmark::State& state)
+{
+    Physics physics;
+    physics.setCourse(courses, 0);
+    physics.setCollisionMode((CollisionMode)state.range(0));
+
+    glm::vec3 impulse = getShotDirection(0.0f, 0.3f) * maxImpulseStrength;
+    physics.applyImpulse(impulse);
+
+    for (auto _ : state)
+    {
+        physics.fixedStep();
+
+        // Relancer la balle pour ne jamais mesurer une balle endormie
+        if (physics.isAsleep() || physics.isInHole())
+        {
+            physics.reset();
+            physics.applyImpulse(impulse);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(state.range(0) == DiscreteCollision ? "discrete" : "continuous");
+}
+BENCHMARK(BM_PhysicsFixedStep)->ArgName("mode")->Arg(DiscreteCollision)->Arg(ContinuousCollision);
+
+static void BM_CheckSphereBounds(benchmark::State& state)
+{
+    int course = (int)state.range(0);
+    WallSet walls = courses.getWalls(course);
+
+    std::vector<glm::vec3> positions, velocities;
+    makeWallSamples(course, positions, velocities);
+
+    size_t i = 0;
+    int wallContacts = 0;
+    for (auto _ : state)
+    {
+        glm::vec3 position = positions[i];
+        glm::vec3 velocity = velocities[i];
+        checkSphereBounds(walls, position, velocity, wallContacts);
+        benchmark::DoNotOptimize(position);
+        benchmark::DoNotOptimize(velocity);
+        i = (i + 1) % positions.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckSphereBounds)->ArgName("course")->DenseRange(0, 2);
+
+static void BM_CheckHoleCollision(benchmark::State& state)
+{
+    std::vector<glm::vec3> positions, velocities;
+    makeWallSamples(0, positions, velocities);
+    glm::vec3 holePosition = courses.getCourse(0).holePosition;
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(checkHoleCollision(positions[i], holePosition));
+        i = (i + 1) % positions.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckHoleCollision);
+
+// Envoi du maillage de la balle du jeu (tables calcules  la compilation)
+static void BM_SetupSphere(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    for (auto _ : state)
+        setupSphere();
+
+    glFinish();
+}
+BENCHMARK(BM_SetupSphere);
+
+// Mme chose avec la classe Sphere (construction puis destruction)
+static void BM_SphereSetupMesh(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    for (auto _ : state)
+    {
+        Sphere sphere;
+        benchmark::DoNotOptimize(&sphere);
+    }
+
+    glFinish();
+}
+BENCHMARK(BM_SphereSetupMesh);
+
+// Construction des programmes de la scne : compilation complte (cold) ou relecture
+// des binaires lis depuis le cache (warm)
+static void BM_LoadShaderPrograms(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    bool warm = state.range(0) != 0;
+    const char* cachePath = "golf_bench_shaders.bin";
+    std::remove(cachePath);
+
+    GLuint programs[sceneShaderCount];
+    ShaderLoadStats stats = {};
+    if (warm)
+    {
+        loadShaderPrograms(sceneShaderSources, sceneShaderCount, programs, cachePath);
+        for (GLuint program : programs)
+            glDeleteProgram(program);
+    }
+
+    for (auto _ : state)
+    {
+        loadShaderPrograms(sceneShaderSources, sceneShaderCount, programs, warm ? cachePath : nullptr, &stats);
+        for (GLuint program : programs)
+            glDeleteProgram(program);
+    }
+
+    state.counters["cache_hits"] = stats.cacheHits;
+    std::remove(cachePath);
+}
+BENCHMARK(BM_LoadShaderPrograms)->ArgName("warm")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Atlas de la police du HUD : rastrisation FreeType, ou relecture du fichier  ct de la police
+static void BM_LoadFontAtlas(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    bool warm = state.range(0) != 0;
+    FontAtlas font;
+    if (warm)
+        font.load(hudFontPath, hudFontSize);
+
+    for (auto _ : state)
+        font.load(hudFontPath, hudFontSize, warm);
+
+    state.counters["cached"] = font.wasCached() ? 1 : 0;
+    font.release();
+}
+BENCHMARK(BM_LoadFontAtlas)->ArgName("warm")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Changement de parcours (touches du pav numrique, fin de trou)
+static void BM_LoadSceneCourse(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    int course = 0;
+    for (auto _ : state)
+    {
+        loadSceneCourse(courses, course);
+        course = (course + 1) % courses.getCourseCount();
+    }
+
+    glFinish();
+}
+BENCHMARK(BM_LoadSceneCourse);
+
+// Une image complte : trane pleine, tous les objets de la scne
+static void drawFrame(benchmark::State& state, int course, int trailLength, bool finish)
+{
+    if (!requireGL(state))
+        return;
+
+    setTrailLength(trailLength);
+    loadSceneCourse(courses, course);
+
+    SceneView scene;
+    scene.width = benchWidth;
+    scene.height = benchHeight;
+    scene.angleX = 0.3f;
+    scene.angleY = 0.0f;
+    scene.zoom = 5.0f;
+    scene.ballPosition = courses.getCourse(course).startPosition;
+    scene.ballRotation = glm::mat4(1.0f);
+
+    for (int i = 0; i < trailLength; ++i)
+        pushTrailPosition(scene.ballPosition + glm::vec3(0.0f, 0.0f, -0.2f * i));
+    updatePowerGauge(0.5f, false);
+
+    for (auto _ : state)
+    {
+        drawScene(scene);
+        if (finish)
+            glFinish(); // Attendre la fin du rendu (llvmpipe rend sur le CPU)
+        else
+            glFlush();
+    }
+
+    glFinish();
+    state.SetItemsProcessed(state.iterations());
+    const RenderStats& stats = getRenderStats();
+    state.counters["draw_calls"] = stats.drawCalls;
+    state.counters["state_changes"] = stats.getStateChanges();
+    setTrailLength(defaultTrailLength);
+}
+
+static void BM_DrawFrameSubmit(benchmark::State& state)
+{
+    drawFrame(state, (int)state.range(0), defaultTrailLength, false);
+}
+BENCHMARK(BM_DrawFrameSubmit)->ArgName("course")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void BM_DrawFrame(benchmark::State& state)
+{
+    drawFrame(state, (int)state.range(0), defaultTrailLength, true);
+}
+BENCHMARK(BM_DrawFrame)->ArgName("course")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Cot d'envoi d'une image selon la longueur de la trane (sphres hors champ limines, une commande instancie par niveau de dtail)
+static void BM_DrawFrameTrail(benchmark::State& state)
+{
+    drawFrame(state, 0, (int)state.range(0), false);
+}
+BENCHMARK(BM_DrawFrameTrail)->ArgName("trail")->Arg(50)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Ajout d'une position  la trane : un seul emplacement du tampon circulaire est envoy
+static void BM_PushTrailPosition(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    setTrailLength((int)state.range(0));
+    glm::vec3 position(0.0f, ballRadius, 0.0f);
+    for (auto _ : state)
+    {
+        pushTrailPosition(position);
+        position.z += 0.01f;
+    }
+
+    glFinish();
+    setTrailLength(defaultTrailLength);
+}
+BENCHMARK(BM_PushTrailPosition)->ArgName("trail")->Arg(50)->Arg(10000);
+
+// Mise  jour de la jauge  chaque image : rien n'est envoy tant que sa couleur ne change pas
+// (charging:0), une copie par image pendant la charge d'un tir (charging:1)
+static void BM_UpdatePowerGauge(benchmark::State& state)
+{
+    if (!requireGL(state))
+        return;
+
+    bool charging = state.range(0) != 0;
+    int frame = 0;
+    for (auto _ : state)
+    {
+        updatePowerGauge(charging ? (frame % 100) / 100.0f : 0.0f, false);
+        ++frame;
+    }
+
+    glFinish();
+    updatePowerGauge(0.0f, false);
+}
+BENCHMARK(BM_UpdatePowerGauge)->ArgName("charging")->Arg(0)->Arg(1);
+
+int main(int argc, char** argv)
+{
+    if (!courses.load(defaultCourseManifest))
+        return 1;
+
+    glReady = createHeadlessContext(benchWidth, benchHeight) && setupScene();
+
+    // Sortie JSON par dfaut, pour suivre les rgressions d'une version  l'autre
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOutput = false;
+    for (int i = 1; i < argc; ++i)
+        hasOutput |= std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+
+    std::string outputArg = "--benchmark_out=golf_bench.json";
+    std::string formatArg = "--benchmark_out_format=json";
+    if (!hasOutput)
+    {
+        args.push_back(&outputArg[0]);
+        args.push_back(&formatArg[0]);
+    }
+
+    int count = (int)args.size();
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+
+    if (glReady)
+        benchmark::AddCustomContext("gl_renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    destroyHeadlessContext();
+    return 0;
+}
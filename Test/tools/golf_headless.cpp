@@ -0,0 +1,402 @@
+// Mode sans cran du jeu : rendu d'une squence scripte (ou d'un enregistrement --record)
+// dans un framebuffer hors cran, sur un contexte EGL (Mesa llvmpipe suffit, pas besoin de GPU).
+// Donne pour chaque image le temps CPU de soumission, l'attente de glFinish() et le temps GPU
+// (horodatages GL_TIMESTAMP), et peut crire des images PNG de rfrence pour reprer les
+// rgressions visuelles. Avec llvmpipe, le rendu a lieu pendant glFinish() : les horodatages
+// n'y mesurent que la soumission et c'est l'attente qui donne le cot du rendu.
+//
+//  lancer depuis le dossier Test (shaders et parcours).
+//
+// Usage : golf_headless [--frames n] [--size LxH] [--replay enregistrement] [--csv fichier]
+//                       [--png dossier] [--png-every n] [--profile-trace fichier] [--profile-csv fichier]
+//                       [--leak-check n]
+//
+// Sans --replay, chaque parcours est jou pendant --frames images (300 par dfaut) : la camra
+// tourne autour de la balle, la jauge se charge pendant une seconde puis la balle est tire vers le trou.
+//
+// --leak-check n fait ensuite n tours de changements de parcours (en recrant au passage la
+// gomtrie des parcours, la balle et la trane) et choue (code 1) si le nombre d'objets
+// OpenGL ou leur taille augmente, ou si des objets survivent  releaseScene().
+
+#include "gpu_profiler.h"
+#include "headless_gl.h"
+#include "png_writer.h"
+#include "replay.h"
+#include "scene.h"
+#include <gtc/matrix_transform.hpp>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int defaultFramesPerCourse = 300;
+const int chargeFrames = 60; // Appui sur E avant le tir script
+const float scriptedShotRatio = 0.7f;
+
+struct FrameTiming
+{
+    int course;
+    double cpuMilliseconds;     // Simulation et soumission des commandes
+    double finishMilliseconds;  // Attente de la fin du rendu (glFinish)
+    GLuint queries[2];          // GL_TIMESTAMP avant et aprs drawScene()
+    double gpuMilliseconds;
+    int drawCalls;
+    int stateChanges;
+};
+
+struct HeadlessOptions
+{
+    int frames;             // 0 : valeur par dfaut
+    int width;
+    int height;
+    const char* replayPath;
+    const char* csvPath;
+    const char* pngDirectory;
+    int pngEvery;
+    const char* profileTracePath;   // Mesures du profileur (GOLF_PROFILE)
+    const char* profileCsvPath;
+    int leakCheckCycles;            // 0 : pas de vrification
+};
+
+static bool parseOptions(int argc, char** argv, HeadlessOptions& options)
+{
+    options.frames = 0;
+    options.width = 1080; // Taille de la fentre du jeu
+    options.height = 720;
+    options.replayPath = nullptr;
+    options.csvPath = nullptr;
+    options.pngDirectory = nullptr;
+    options.pngEvery = 60;
+    options.profileTracePath = nullptr;
+    options.profileCsvPath = nullptr;
+    options.leakCheckCycles = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--headless") // Accept pour garder la mme ligne de commande que le jeu
+            continue;
+        if (i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if (option == "--frames")
+            options.frames = std::atoi(value);
+        else if (option == "--size")
+        {
+            if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2)
+                return false;
+        }
+        else if (option == "--replay")
+            options.replayPath = value;
+        else if (option == "--csv")
+            options.csvPath = value;
+        else if (option == "--png")
+            options.pngDirectory = value;
+        else if (option == "--png-every")
+            options.pngEvery = std::atoi(value);
+        else if (option == "--profile-trace")
+            options.profileTracePath = value;
+        else if (option == "--profile-csv")
+            options.profileCsvPath = value;
+        else if (option == "--leak-check")
+            options.leakCheckCycles = std::atoi(value);
+        else
+            return false;
+    }
+    return options.frames >= 0 && options.width > 0 && options.height > 0 && options.pngEvery > 0 && options.leakCheckCycles >= 0;
+}
+
+static bool savePng(const HeadlessOptions& options, int frame)
+{
+    std::vector<unsigned char> pixels((size_t)options.width * options.height * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, options.width, options.height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    // OpenGL lit de bas en haut, le PNG commence par la ligne du haut
+    size_t rowSize = (size_t)options.width * 3;
+    std::vector<unsigned char> flipped(pixels.size());
+    for (int y = 0; y < options.height; ++y)
+        std::memcpy(&flipped[rowSize * y], &pixels[rowSize * (options.height - 1 - y)], rowSize);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "/frame_%05d.png", frame);
+    return writePng((std::string(options.pngDirectory) + name).c_str(), options.width, options.height, flipped.data());
+}
+
+static double percentile(std::vector<double> values, double ratio)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(ratio * (values.size() - 1) + 0.5))];
+}
+
+static void printSummary(const char* name, const std::vector<double>& values)
+{
+    double sum = 0.0;
+    for (double value : values)
+        sum += value;
+
+    std::cout << name << " : moyenne " << (values.empty() ? 0.0 : sum / values.size()) << " ms, mdiane " << percentile(values, 0.5)
+              << " ms, p95 " << percentile(values, 0.95) << " ms, max " << percentile(values, 1.0) << " ms" << std::endl;
+}
+
+// Un tour : chaque parcours affich une image, puis ce que le jeu peut recrer en cours de partie
+static void runLeakCheckCycle(const CourseLibrary& courses, const HeadlessOptions& options, int cycle)
+{
+    for (int course = 0; course < courses.getCourseCount(); ++course)
+    {
+        loadSceneCourse(courses, course);
+
+        SceneView scene;
+        scene.width = options.width;
+        scene.height = options.height;
+        scene.angleX = 0.35f;
+        scene.angleY = 0.0f;
+        scene.zoom = 8.0f;
+        scene.ballPosition = courses.getCourse(course).startPosition;
+        scene.ballRotation = glm::mat4(1.0f);
+
+        pushTrailPosition(scene.ballPosition);
+        addHudText("Parcours " + std::to_string(course + 1), 10.0f, 35.0f, 0.5f, glm::vec3(1.0f));
+        drawScene(scene);
+    }
+    setupCourseGeometry(courses);
+    setupSphere();
+    setTrailLength(defaultTrailLength + cycle % 2); // Rallocation du tampon circulaire
+    glFinish();
+}
+
+static bool checkResourceLeaks(const CourseLibrary& courses, const HeadlessOptions& options)
+{
+    // Le premier tour cre ce qui ne l'est qu' la premire utilisation (tampon du texte, etc.)
+    runLeakCheckCycle(courses, options, 0);
+    int countBefore = glResources.getTotalCount();
+    size_t bytesBefore = glResources.getTotalBytes();
+
+    for (int cycle = 1; cycle <= options.leakCheckCycles; ++cycle)
+        runLeakCheckCycle(courses, options, cycle);
+
+    // Un nombre pair de tours remet la trane  sa taille de dpart
+    if (options.leakCheckCycles % 2)
+        setTrailLength(defaultTrailLength);
+
+    int countAfter = glResources.getTotalCount();
+    size_t bytesAfter = glResources.getTotalBytes();
+    std::cout << "Objets OpenGL aprs " << options.leakCheckCycles << " tours : " << countBefore << " -> " << countAfter << " objets, "
+              << bytesBefore << " -> " << bytesAfter << " octets\n" << glResources.getReport();
+    if (countAfter > countBefore || bytesAfter > bytesBefore)
+    {
+        std::cerr << "Fuite d'objets OpenGL entre les changements de parcours" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage : golf_headless [--frames n] [--size LxH] [--replay enregistrement] [--csv fichier] [--png dossier] [--png-every n]"
+                  << " [--profile-trace fichier] [--profile-csv fichier] [--leak-check n]" << std::endl;
+        return 1;
+    }
+
+    CourseLibrary courses;
+    if (!courses.load(defaultCourseManifest))
+        return 1;
+
+    ReplayPlayer player;
+    if (options.replayPath && !player.load(options.replayPath, courses))
+        return 1;
+
+    if (options.pngDirectory)
+        mkdir(options.pngDirectory, 0755); // Dj prsent : writePng() signalera les vraies erreurs
+
+    if (!createHeadlessContext(options.width, options.height))
+        return 1;
+    if (!createOffscreenTarget(options.width, options.height) || !setupScene())
+    {
+        destroyHeadlessContext();
+        return 1;
+    }
+    std::cout << "Rendu : " << glGetString(GL_RENDERER) << ", " << options.width << "x" << options.height << std::endl;
+
+    Physics physics;
+    int course = 0;
+    physics.setCourse(courses, course);
+    loadSceneCourse(courses, course);
+
+    // Avec un enregistrement, la relecture dcide des parcours (--frames limite alors la dure) ;
+    // sinon chaque parcours a --frames images
+    int framesPerCourse = options.frames > 0 ? options.frames : defaultFramesPerCourse;
+    int frameCount = framesPerCourse * courses.getCourseCount();
+    if (options.replayPath)
+    {
+        frameCount = (int)player.getStepCount() + 60;
+        if (options.frames > 0)
+            frameCount = std::min(frameCount, options.frames);
+    }
+
+#ifdef GOLF_PROFILE
+    profiler.setRecording(options.profileTracePath || options.profileCsvPath);
+#else
+    if (options.profileTracePath || options.profileCsvPath)
+        std::cerr << "Profileur absent de cette version (GOLF_ENABLE_PROFILER)" << std::endl;
+#endif
+
+    std::vector<FrameTiming> timings(frameCount);
+    glm::mat4 ballRotation = glm::mat4(1.0f);
+
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        FrameTiming& timing = timings[frame];
+        auto start = std::chrono::steady_clock::now();
+
+        int scriptFrame = frame % framesPerCourse;
+        float powerRatio = 0.0f;
+        if (options.replayPath)
+        {
+            if (player.step(physics, courses, course, fixedTimeStep))
+                loadSceneCourse(courses, course);
+        }
+        else
+        {
+            if (scriptFrame == 0 && frame > 0)
+            {
+                course = (course + 1) % courses.getCourseCount();
+                physics.setCourse(courses, course);
+                loadSceneCourse(courses, course);
+            }
+
+            if (scriptFrame < chargeFrames)
+            {
+                powerRatio = scriptedShotRatio * scriptFrame / chargeFrames;
+            }
+            else if (scriptFrame == chargeFrames)
+            {
+                glm::vec3 toHole = physics.getCourse().holePosition - physics.getBall().position;
+                toHole.y = 0.0f;
+                physics.applyImpulse(glm::normalize(toHole) * (scriptedShotRatio * maxImpulseStrength));
+            }
+            physics.step(fixedTimeStep);
+        }
+
+        // Rotation de la balle qui roule
+        const glm::vec3& velocity = physics.getBall().velocity;
+        float speed = glm::length(velocity);
+        if (speed > 0.0f)
+        {
+            glm::vec3 axis = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), velocity));
+            ballRotation = glm::rotate(glm::mat4(1.0f), speed * (float)fixedTimeStep / ballRadius, axis) * ballRotation;
+        }
+
+        SceneView scene;
+        scene.width = options.width;
+        scene.height = options.height;
+        scene.angleX = 0.35f;
+        scene.angleY = 0.6f * sinf(frame * 0.02f); // Camra qui oscille autour de la balle
+        scene.zoom = 8.0f;
+        if (options.replayPath && player.getCamera().valid) // Camra du joueur enregistre
+        {
+            scene.angleX = player.getCamera().angleX;
+            scene.angleY = player.getCamera().angleY;
+            scene.zoom = player.getCamera().zoom;
+        }
+        scene.ballPosition = physics.getBall().position;
+        scene.ballRotation = ballRotation;
+
+        updatePowerGauge(powerRatio, false);
+        pushTrailPosition(scene.ballPosition);
+
+        // Mmes textes que le HUD du jeu
+        int shots = !options.replayPath && scriptFrame >= chargeFrames ? 1 : 0;
+        addHudText("Parcours " + std::to_string(course + 1) + "/" + std::to_string(courses.getCourseCount()), 10.0f, 35.0f, 0.5f, glm::vec3(1.0f));
+        addHudText("Coups : " + std::to_string(shots), 10.0f, 12.0f, 0.5f, glm::vec3(1.0f));
+        addHudText(std::to_string(frame) + " / " + std::to_string(frameCount), 600.0f, 530.0f, 0.4f, glm::vec3(1.0f));
+
+        glGenQueries(2, timing.queries);
+        glQueryCounter(timing.queries[0], GL_TIMESTAMP);
+        drawScene(scene);
+        glQueryCounter(timing.queries[1], GL_TIMESTAMP);
+
+        auto submitted = std::chrono::steady_clock::now();
+        glFinish(); // Images indpendantes : chaque mesure ne contient que son propre rendu
+        timing.cpuMilliseconds = std::chrono::duration<double, std::milli>(submitted - start).count();
+        timing.finishMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitted).count();
+        timing.course = course;
+        timing.drawCalls = getRenderStats().drawCalls;
+        timing.stateChanges = getRenderStats().getStateChanges();
+
+        if (options.pngDirectory && frame % options.pngEvery == 0 && !savePng(options, frame))
+            options.pngDirectory = nullptr;
+
+        PROFILE_GPU_COLLECT();
+        PROFILE_END_FRAME();
+    }
+
+    // Rsultats des requtes lus  la fin pour ne pas attendre le GPU  chaque image
+    std::vector<double> cpuTimes, finishTimes, gpuTimes;
+    for (FrameTiming& timing : timings)
+    {
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(timing.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(timing.queries[1], GL_QUERY_RESULT, &end);
+        glDeleteQueries(2, timing.queries);
+        timing.gpuMilliseconds = (end - begin) / 1.0e6;
+        cpuTimes.push_back(timing.cpuMilliseconds);
+        finishTimes.push_back(timing.finishMilliseconds);
+        gpuTimes.push_back(timing.gpuMilliseconds);
+    }
+
+    if (options.csvPath)
+    {
+        std::ofstream csv(options.csvPath);
+        csv << "frame,course,cpu_ms,finish_ms,gpu_ms,draw_calls,state_changes\n";
+        for (size_t i = 0; i < timings.size(); ++i)
+        {
+            const FrameTiming& timing = timings[i];
+            csv << i << "," << timing.course << "," << timing.cpuMilliseconds << "," << timing.finishMilliseconds << "," << timing.gpuMilliseconds << ","
+                << timing.drawCalls << "," << timing.stateChanges << "\n";
+        }
+    }
+
+    std::cout << frameCount << " images" << std::endl;
+    printSummary("CPU", cpuTimes);
+    printSummary("Attente", finishTimes);
+    printSummary("GPU", gpuTimes);
+    std::cout << "Tampon de flux : " << (getSceneStream().isPersistent() ? "projection persistante" : "orphelinage") << ", "
+              << getSceneStream().getStallCount() << " attente(s) du GPU" << std::endl;
+
+#ifdef GOLF_PROFILE
+    std::cout << "Profileur : " << profiler.getSummary() << std::endl;
+    if (options.profileTracePath)
+        profiler.writeChromeTrace(options.profileTracePath);
+    if (options.profileCsvPath)
+        profiler.writeCsv(options.profileCsvPath);
+    gpuProfiler.release();
+#endif
+
+    bool leakFree = true;
+    if (options.leakCheckCycles > 0)
+        leakFree = checkResourceLeaks(courses, options);
+
+    releaseScene();
+    if (glResources.getTotalCount() > 0)
+    {
+        std::cerr << "Objets OpenGL non librs par releaseScene() :\n" << glResources.getReport();
+        leakFree = false;
+    }
+
+    destroyOffscreenTarget();
+    destroyHeadlessContext();
+    return leakFree ? 0 : 1;
+}
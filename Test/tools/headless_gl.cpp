@@ -0,0 +1,136 @@
+#include "headless_gl.h"
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <iostream>
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLSurface surface = EGL_NO_SURFACE;
+static EGLContext context = EGL_NO_CONTEXT;
+static GLuint framebuffer, colorRenderbuffer, depthRenderbuffer;
+
+static EGLDisplay getHeadlessDisplay()
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+    {
+        EGLDisplay surfaceless = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (surfaceless != EGL_NO_DISPLAY)
+            return surfaceless;
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool createHeadlessContext(int width, int height)
+{
+    display = getHeadlessDisplay();
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        std::cerr << "chec de l'initialisation d'EGL" << std::endl;
+        return false;
+    }
+
+    const EGLint configAttributes[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cerr << "Aucune configuration EGL compatible" << std::endl;
+        return false;
+    }
+
+    const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+    // Profil de compatibilit comme la fentre GLFW du jeu (GL_QUADS, glBegin)
+    const EGLint contextAttributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+        EGL_NONE
+    };
+    eglBindAPI(EGL_OPENGL_API);
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+    {
+        std::cerr << "chec de la cration du contexte OpenGL" << std::endl;
+        destroyHeadlessContext();
+        return false;
+    }
+
+    GLenum err = glewInit();
+    if (err != GLEW_OK)
+    {
+        std::cerr << "chec de l'initialisation de GLEW" << std::endl;
+        destroyHeadlessContext();
+        return false;
+    }
+
+    glViewport(0, 0, width, height);
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    return true;
+}
+
+void destroyHeadlessContext()
+{
+    if (display == EGL_NO_DISPLAY)
+        return;
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT)
+        eglDestroyContext(display, context);
+    if (surface != EGL_NO_SURFACE)
+        eglDestroySurface(display, surface);
+    eglTerminate(display);
+
+    display = EGL_NO_DISPLAY;
+    surface = EGL_NO_SURFACE;
+    context = EGL_NO_CONTEXT;
+}
+
+bool createOffscreenTarget(int width, int height)
+{
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "Framebuffer hors cran incomplet" << std::endl;
+        destroyOffscreenTarget();
+        return false;
+    }
+
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void destroyOffscreenTarget()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorRenderbuffer);
+    glDeleteRenderbuffers(1, &depthRenderbuffer);
+    framebuffer = colorRenderbuffer = depthRenderbuffer = 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Contexte OpenGL sans fentre pour les outils : EGL avec un pbuffer, sur la plateforme
+// "surfaceless" de Mesa quand elle existe (llvmpipe sur une machine sans cran).
+// GLEW doit tre compil avec GLEW_EGL pour charger les fonctions par eglGetProcAddress.
+
+bool createHeadlessContext(int width, int height);
+void destroyHeadlessContext();
+
+// Rendu dans un framebuffer (couleur RGBA8 + profondeur 24 bits) plutt que dans le pbuffer,
+// comme le ferait le jeu sur une cible hors cran. Le framebuffer reste li aprs la cration.
+bool createOffscreenTarget(int width, int height);
+void destroyOffscreenTarget();
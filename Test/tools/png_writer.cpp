@@ -0,0 +1,118 @@
+#include "png_writer.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static uint32_t crcTable[256];
+
+static void buildCrcTable()
+{
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+    }
+}
+
+static uint32_t updateCrc(uint32_t crc, const unsigned char* bytes, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        crc = crcTable[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void putUint32(std::vector<unsigned char>& out, uint32_t value)
+{
+    out.push_back((unsigned char)(value >> 24));
+    out.push_back((unsigned char)(value >> 16));
+    out.push_back((unsigned char)(value >> 8));
+    out.push_back((unsigned char)value);
+}
+
+// Longueur, type, donnes, CRC du type et des donnes
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> chunk;
+    putUint32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+
+    uint32_t crc = updateCrc(0xFFFFFFFFu, chunk.data() + 4, chunk.size() - 4) ^ 0xFFFFFFFFu;
+    putUint32(chunk, crc);
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool writePng(const char* path, int width, int height, const unsigned char* rgb)
+{
+    static bool tableReady = false;
+    if (!tableReady)
+    {
+        buildCrcTable();
+        tableReady = true;
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Impossible d'crire " << path << std::endl;
+        return false;
+    }
+
+    const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    putUint32(header, (uint32_t)width);
+    putUint32(header, (uint32_t)height);
+    header.push_back(8); // Bits par composante
+    header.push_back(2); // RGB
+    header.push_back(0); // Compression deflate
+    header.push_back(0); // Filtres standard
+    header.push_back(0); // Pas d'entrelacement
+    writeChunk(file, "IHDR", header);
+
+    // Lignes prcdes de leur filtre (0 : aucun)
+    size_t rowSize = (size_t)width * 3;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb + rowSize * y, rgb + rowSize * (y + 1));
+    }
+
+    // Flux zlib : en-tte, blocs non compresss d'au plus 65535 octets, Adler-32
+    std::vector<unsigned char> data;
+    data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    data.push_back(0x78);
+    data.push_back(0x01);
+    size_t offset = 0;
+    do
+    {
+        size_t blockSize = std::min<size_t>(raw.size() - offset, 65535);
+        bool last = offset + blockSize == raw.size();
+        data.push_back(last ? 1 : 0);
+        data.push_back((unsigned char)blockSize);
+        data.push_back((unsigned char)(blockSize >> 8));
+        data.push_back((unsigned char)~blockSize);
+        data.push_back((unsigned char)(~blockSize >> 8));
+        data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putUint32(data, (b << 16) | a);
+    writeChunk(file, "IDAT", data);
+
+    writeChunk(file, "IEND", std::vector<unsigned char>());
+    return file.good();
+}
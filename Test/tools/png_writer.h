@@ -0,0 +1,7 @@
+#pragma once
+
+// criture d'images PNG sans dpendance : pixels RGB 8 bits, donnes zlib non compresses
+// (blocs "stored"). Suffisant pour les images de rfrence des outils.
+
+// rgb : width * height * 3 octets, la premire ligne est le haut de l'image
+bool writePng(const char* path, int width, int height, const unsigned char* rgb);
@@ -0,0 +1,52 @@
+// Rejoue un enregistrement de partie (Test --record) sans rendu, aussi vite que possible,
+// et vrifie que l'tat final de la balle est identique  celui de l'enregistrement.
+//
+// Usage : replay_player <enregistrement> [rptitions] [manifeste]
+
+#include "replay.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage : replay_player <enregistrement> [rptitions] [manifeste]" << std::endl;
+        return 1;
+    }
+
+    int repeat = argc > 2 ? std::atoi(argv[2]) : 1;
+    const char* manifestPath = argc > 3 ? argv[3] : defaultCourseManifest;
+    if (repeat <= 0)
+        repeat = 1;
+
+    CourseLibrary courses;
+    if (!courses.load(manifestPath))
+        return 1;
+
+    ReplayPlayer player;
+    if (!player.load(argv[1], courses))
+        return 1;
+
+    bool same = true;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < repeat && same; ++i)
+    {
+        player.rewind();
+
+        Physics physics;
+        int course = 0;
+        player.run(physics, courses, course);
+        same = player.verify(physics, course);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simulated = (double)player.getStepCount() * fixedTimeStep * repeat;
+
+    std::cout << player.getEventCount() << " vnements, " << player.getStepCount() << " pas (" << player.getStepCount() * fixedTimeStep << " s de jeu) rejous "
+              << repeat << " fois en " << seconds << " s, " << (long long)(simulated / seconds) << "x le temps rel" << std::endl;
+    std::cout << (same ? "tat final identique  l'enregistrement" : "Divergence avec l'enregistrement") << std::endl;
+    return same ? 0 : 1;
+}
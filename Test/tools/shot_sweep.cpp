@@ -0,0 +1,178 @@
+// Balayage de tirs : simule une grille angle x puissance sur un parcours, sur tous les coeurs,
+// et crit la carte des rsultats en CSV.
+//
+// Usage : shot_sweep [--continuous | --analytic | --batch] <parcours> [pas d'angle] [pas de puissance] [sortie.csv] [threads] [manifeste]
+//
+// Par dfaut (ou avec --continuous) chaque tir est simul avec Physics en collision continue,
+// le modle du jeu. --analytic prdit chaque tir d'impact en impact (predictShot), mme modle.
+// --batch passe par le simulateur SIMD multi-balles, en collisions discrtes : plus rapide sur
+// beaucoup de coeurs mais moins fidle (les tirs forts peuvent traverser les murs).
+
+#include "ball_batch.h"
+#include "physics.h"
+#include <gtc/constants.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int maxShotSteps = 60 * 60; // Une minute de simulation au maximum par tir
+const int shotsPerBatch = 64; // Nombre de tirs pris d'un coup par un thread
+
+struct SweepShot
+{
+    float angle;
+    float power;
+    ShotResult result;
+};
+
+int main(int argc, char** argv)
+{
+    std::string mode = argc > 1 ? argv[1] : "";
+    bool analytic = mode == "--analytic";
+    bool batched = mode == "--batch";
+    if (analytic || batched || mode == "--continuous")
+    {
+        argv++;
+        argc--;
+    }
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage : shot_sweep [--continuous | --analytic | --batch] <parcours> [pas d'angle] [pas de puissance] [sortie.csv] [threads] [manifeste]" << std::endl;
+        return 1;
+    }
+
+    int course = std::atoi(argv[1]) - 1;
+    int angleSteps = argc > 2 ? std::atoi(argv[2]) : 360;
+    int powerSteps = argc > 3 ? std::atoi(argv[3]) : 100;
+    std::string outputPath = argc > 4 ? argv[4] : "shot_sweep.csv";
+    int threadCount = argc > 5 ? std::atoi(argv[5]) : (int)std::thread::hardware_concurrency();
+    const char* manifestPath = argc > 6 ? argv[6] : defaultCourseManifest;
+
+    CourseLibrary courses;
+    if (!courses.load(manifestPath))
+        return 1;
+
+    if (course < 0 || course >= courses.getCourseCount() || angleSteps <= 0 || powerSteps <= 0)
+    {
+        std::cerr << "Paramtres invalides" << std::endl;
+        return 1;
+    }
+    if (threadCount <= 0)
+        threadCount = 1;
+
+    // Grille : angle de camra (angleY) sur un tour complet, puissance de 0 (exclu)  maxImpulseStrength
+    std::vector<SweepShot> shots(angleSteps * powerSteps);
+    for (int a = 0; a < angleSteps; ++a)
+    {
+        for (int p = 0; p < powerSteps; ++p)
+        {
+            SweepShot& shot = shots[a * powerSteps + p];
+            shot.angle = a * 2.0f * glm::pi<float>() / angleSteps;
+            shot.power = (p + 1) * maxImpulseStrength / powerSteps;
+        }
+    }
+
+    std::atomic<size_t> nextShot(0);
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            size_t first = nextShot.fetch_add(shotsPerBatch);
+            if (first >= shots.size())
+                break;
+
+            size_t last = std::min(first + shotsPerBatch, shots.size());
+
+            if (analytic)
+            {
+                for (size_t i = first; i < last; ++i)
+                    shots[i].result = predictShot(courses, course, getShotDirection(0.0f, shots[i].angle) * shots[i].power);
+                continue;
+            }
+
+            if (!batched)
+            {
+                for (size_t i = first; i < last; ++i)
+                    shots[i].result = simulateShot(courses, course, getShotDirection(0.0f, shots[i].angle) * shots[i].power, maxShotSteps, ContinuousCollision);
+                continue;
+            }
+
+            // Un lot de tirs avance ensemble dans le simulateur SIMD multi-balles
+            BallBatch batch;
+            batch.setCourse(courses, course);
+            for (size_t i = first; i < last; ++i)
+            {
+                int ball = batch.addBall();
+                batch.applyImpulse(ball, getShotDirection(0.0f, shots[i].angle) * shots[i].power);
+            }
+
+            std::vector<unsigned char> finished(last - first, 0);
+            size_t remaining = last - first;
+            for (int step = 1; step <= maxShotSteps && remaining > 0; ++step)
+            {
+                batch.fixedStep();
+
+                for (int ball = 0; ball < batch.size(); ++ball)
+                {
+                    if (finished[ball])
+                        continue;
+
+                    if (batch.isInHole(ball) || batch.isAtRest(ball) || step == maxShotSteps)
+                    {
+                        ShotResult& result = shots[first + ball].result;
+                        result.finalPosition = batch.getPosition(ball);
+                        result.inHole = batch.isInHole(ball);
+                        result.wallContacts = batch.getWallContacts(ball);
+                        result.steps = step;
+                        finished[ball] = 1;
+                        remaining--;
+                    }
+                }
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream output(outputPath);
+    if (!output.is_open())
+    {
+        std::cerr << "Impossible d'crire " << outputPath << std::endl;
+        return 1;
+    }
+
+    output << "angle,power,x,y,z,hole,wall_contacts,steps\n";
+    int holesInOne = 0;
+    long long totalSteps = 0;
+    for (const SweepShot& shot : shots)
+    {
+        const ShotResult& r = shot.result;
+        output << shot.angle << ',' << shot.power << ','
+               << r.finalPosition.x << ',' << r.finalPosition.y << ',' << r.finalPosition.z << ','
+               << (r.inHole ? 1 : 0) << ',' << r.wallContacts << ',' << r.steps << '\n';
+        holesInOne += r.inHole ? 1 : 0;
+        totalSteps += r.steps;
+    }
+
+    std::cout << shots.size() << " tirs simuls en " << seconds << " s sur " << threadCount << " threads, "
+              << (batched ? std::string("noyau ") + BallBatch::getKernelName(BallBatch::getBestKernel()) : analytic ? "prdiction analytique" : "collision continue") << " ("
+              << (long long)(shots.size() / seconds) << " tirs/s, " << (long long)(totalSteps / seconds) << " pas/s)" << std::endl;
+    std::cout << holesInOne << " trous en un, rsultats crits dans " << outputPath << std::endl;
+
+    return 0;
+}
@@ -1,9 +1,11 @@
 #version 330 core
 out vec4 FragColor;
 
+in float Fade;
+
 uniform vec4 color;
 
 void main()
 {
-    FragColor = color;
+    FragColor = vec4(color.rgb, color.a * Fade);
 }
@@ -1,11 +1,25 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+layout(location = 3) in vec4 aOffset; // Position dans la trainee (xyz) et emplacement (w), une par instance
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Constantes de l'image, remplies une fois par image pour tous les programmes
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 screenProjection;
+    vec4 cameraPosition;
+};
+
+uniform int trailStart; // Plus ancienne position du tampon circulaire
+uniform int trailLength;
+
+out float Fade;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    // Rang depuis la plus ancienne : les nouvelles positions sont plus grandes
+    float index = float((int(aOffset.w) - trailStart + trailLength) % trailLength) / float(trailLength);
+    Fade = 1.0 - index;
+    gl_Position = projection * view * vec4(aOffset.xyz + aPos * (0.5 * index), 1.0);
 }